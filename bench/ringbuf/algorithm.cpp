@@ -0,0 +1,61 @@
+/// Benchmarks for the segmented algorithms.
+
+#include <memory>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algorithm.hpp"
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity>
+using RingBuffer = core::ringbuf::RingBuffer<T, Capacity>;
+
+////////////////////////////////////////////////////////////////
+
+TEST_CASE("Segmented algorithm benchmarks") {
+    // 64 KiB of data with the contents wrapping the end of the buffer.
+    constexpr auto CAPACITY = (64 * 1024) / sizeof(uint32_t);
+
+    auto buf = std::make_unique<RingBuffer<uint32_t, CAPACITY>>();
+    auto vector = std::vector<uint32_t>{};
+
+    for (auto i : std::views::iota(size_t{0}, CAPACITY / 3)) {
+        buf->push_unchecked((uint32_t)i);
+        [[maybe_unused]] auto _ = buf->pop_unchecked();
+    }
+
+    for (auto i : std::views::iota(size_t{0}, CAPACITY)) {
+        buf->push_unchecked((uint32_t)i);
+        vector.push_back((uint32_t)i);
+    }
+
+    BENCHMARK("std::accumulate() over a std::vector") {
+        return std::accumulate(vector.begin(), vector.end(), uint32_t{0});
+    };
+
+    BENCHMARK("Range-for sum over Iterator") {
+        auto sum = uint32_t{0};
+        for (auto value : *buf) sum += value;
+        return sum;
+    };
+
+    BENCHMARK("accumulate() over segments()") {
+        return core::ringbuf::accumulate(*buf, uint32_t{0});
+    };
+
+    auto output = std::vector<uint32_t>(CAPACITY);
+
+    BENCHMARK("std::ranges::copy() over Iterator") {
+        return std::ranges::copy(*buf, output.begin()).out;
+    };
+
+    BENCHMARK("copy() over segments()") {
+        return core::ringbuf::copy(*buf, output.begin());
+    };
+}
@@ -0,0 +1,58 @@
+/// Benchmarks for bulk push_buffer() and pop_buffer() transfers.
+
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T>
+using DynamicRingBuffer = core::ringbuf::DynamicRingBuffer<T>;
+
+/// Fill a buffer with a pattern which doesn't repeat at any power of two.
+auto pattern(const size_t size) -> std::vector<uint8_t> {
+    auto data = std::vector<uint8_t>(size);
+
+    for (auto i : std::views::iota(size_t{0}, size)) {
+        data[i] = (uint8_t)((i * 7) % 251);
+    }
+
+    return data;
+}
+
+/// Move the indices of an empty buffer so the next write of size bytes straddles the wrap.
+auto straddle_wrap(DynamicRingBuffer<uint8_t>& buf, const size_t size) -> void {
+    const auto offset = buf.capacity() - (size / 2);
+
+    static_cast<void>(buf.commit_write(offset));
+    static_cast<void>(buf.consume(offset));
+}
+
+////////////////////////////////////////////////////////////////
+
+TEST_CASE("Bulk transfer benchmarks") {
+    for (auto size : {size_t{1},
+                      size_t{64},
+                      size_t{4096},
+                      size_t{65536},
+                      size_t{256 * 1024},
+                      size_t{1024 * 1024}}) {
+        auto buf = DynamicRingBuffer<uint8_t>::create(2 * size);
+        REQUIRE(buf.has_value());
+
+        const auto write_data = pattern(size);
+        auto read_data = std::vector<uint8_t>(size);
+
+        BENCHMARK("Push and pop " + std::to_string(size) + " bytes across the wrap") {
+            straddle_wrap(*buf, size);
+            static_cast<void>(buf->push_buffer(write_data));
+            static_cast<void>(buf->pop_buffer(read_data));
+            return read_data.back();
+        };
+    }
+}
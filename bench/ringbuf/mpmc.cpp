@@ -0,0 +1,107 @@
+/// Benchmarks for MpmcRingBuffer.
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "mpmc.hpp"
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity>
+using RingBuffer = core::ringbuf::RingBuffer<T, Capacity>;
+
+template<typename T, size_t Capacity>
+using MpmcRingBuffer = core::ringbuf::MpmcRingBuffer<T, Capacity>;
+
+using Error = core::ringbuf::Error;
+
+////////////////////////////////////////////////////////////////
+
+/// RingBuffer guarded by a mutex. Used as the baseline for the MPMC benchmarks.
+template<typename T, size_t Capacity>
+struct LockedRingBuffer {
+    auto try_push(T value) noexcept -> std::expected<void, Error> {
+        auto lock = std::scoped_lock(this->mutex);
+        return this->buffer.push(value);
+    }
+
+    auto try_pop() noexcept -> std::expected<T, Error> {
+        auto lock = std::scoped_lock(this->mutex);
+        return this->buffer.pop();
+    }
+
+private:
+    std::mutex mutex{};
+    RingBuffer<T, Capacity> buffer{};
+};
+
+/// Split count push/pop pairs between threads which all share queue.
+///
+/// Every thread pushes and then pops, so the queue never holds more elements than there are
+/// threads and nobody can wait forever.
+template<typename Queue>
+auto contend(Queue& queue, const size_t threads, const size_t count) -> void {
+    auto workers = std::vector<std::jthread>{};
+
+    for ([[maybe_unused]] auto t : std::views::iota(size_t{0}, threads)) {
+        workers.emplace_back([&] {
+            for (auto i : std::views::iota(size_t{0}, count / threads)) {
+                while (!queue.try_push((uint32_t)i)) continue;
+                while (!queue.try_pop()) continue;
+            }
+        });
+    }
+}
+
+/// As contend(), but moving batches of BATCH elements at a time.
+template<size_t BATCH, typename Queue>
+auto contend_batched(Queue& queue, const size_t threads, const size_t count) -> void {
+    auto workers = std::vector<std::jthread>{};
+
+    for ([[maybe_unused]] auto t : std::views::iota(size_t{0}, threads)) {
+        workers.emplace_back([&] {
+            auto chunk = std::array<uint32_t, BATCH>{};
+
+            for ([[maybe_unused]] auto i : std::views::iota(size_t{0}, count / threads / BATCH)) {
+                while (!queue.try_push_buffer(chunk)) continue;
+                while (!queue.try_pop_buffer(chunk)) continue;
+            }
+        });
+    }
+}
+
+////////////////////////////////////////////////////////////////
+
+TEST_CASE("MpmcRingBuffer benchmarks") {
+    constexpr auto CAPACITY = 1024;
+    constexpr auto COUNT = size_t{64 * 1024};
+    constexpr auto BATCH = size_t{16};
+
+    for (const size_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+        const auto suffix = " with " + std::to_string(threads) + " threads";
+
+        BENCHMARK_ADVANCED("Mutex RingBuffer" + suffix)(Catch::Benchmark::Chronometer meter) {
+            auto queue = LockedRingBuffer<uint32_t, CAPACITY>{};
+            meter.measure([&] { contend(queue, threads, COUNT); });
+        };
+
+        BENCHMARK_ADVANCED("MpmcRingBuffer" + suffix)(Catch::Benchmark::Chronometer meter) {
+            auto queue = std::make_unique<MpmcRingBuffer<uint32_t, CAPACITY>>();
+            meter.measure([&] { contend(*queue, threads, COUNT); });
+        };
+
+        BENCHMARK_ADVANCED("MpmcRingBuffer batched" + suffix)(Catch::Benchmark::Chronometer meter) {
+            auto queue = std::make_unique<MpmcRingBuffer<uint32_t, CAPACITY>>();
+            meter.measure([&] { contend_batched<BATCH>(*queue, threads, COUNT); });
+        };
+    }
+}
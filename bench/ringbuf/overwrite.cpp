@@ -0,0 +1,43 @@
+/// Benchmarks for OverwriteRingBuffer.
+
+#include <ranges>
+
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "overwrite.hpp"
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity>
+using RingBuffer = core::ringbuf::RingBuffer<T, Capacity>;
+
+template<typename T, size_t Capacity>
+using OverwriteRingBuffer = core::ringbuf::OverwriteRingBuffer<T, Capacity>;
+
+////////////////////////////////////////////////////////////////
+
+TEST_CASE("OverwriteRingBuffer benchmarks") {
+    constexpr auto CAPACITY = 1024;
+
+    BENCHMARK_ADVANCED("RingBuffer pop and push")(Catch::Benchmark::Chronometer meter) {
+        auto buf = RingBuffer<uint64_t, CAPACITY>{};
+        while (buf.push(0)) continue;
+
+        meter.measure([&](const int i) {
+            static_cast<void>(buf.pop());
+            return buf.push((uint64_t)i);
+        });
+    };
+
+    BENCHMARK_ADVANCED("OverwriteRingBuffer push")(Catch::Benchmark::Chronometer meter) {
+        auto buf = OverwriteRingBuffer<uint64_t, CAPACITY>{};
+        for ([[maybe_unused]] auto i : std::views::iota(0, CAPACITY)) buf.push(0);
+
+        meter.measure([&](const int i) {
+            buf.push((uint64_t)i);
+            return buf.dropped();
+        });
+    };
+}
@@ -0,0 +1,63 @@
+/// Benchmarks for the execution policy algorithms.
+
+#include <cstdint>
+#include <execution>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "parallel.hpp"
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T>
+using DynamicRingBuffer = core::ringbuf::DynamicRingBuffer<T>;
+
+////////////////////////////////////////////////////////////////
+
+/// Deliberately expensive per-element work, standing in for checksumming or decoding.
+constexpr auto mix(uint32_t value) noexcept -> uint32_t {
+    for (auto round = 0; round < 16; round++) {
+        value ^= value >> 16;
+        value *= 0x7FEB352D;
+        value ^= value >> 15;
+    }
+
+    return value;
+}
+
+TEST_CASE("Execution policy algorithm benchmarks") {
+    // 64 MiB of data with the contents wrapping the end of the buffer.
+    constexpr auto CAPACITY = (64 * 1024 * 1024) / sizeof(uint32_t);
+
+    auto buf = std::move(*DynamicRingBuffer<uint32_t>::create(CAPACITY));
+
+    for (auto i = size_t{0}; i < CAPACITY / 3; i++) {
+        buf.push_unchecked(0);
+        [[maybe_unused]] auto _ = buf.pop_unchecked();
+    }
+
+    for (auto i = size_t{0}; i < CAPACITY; i++) {
+        buf.push_unchecked(static_cast<uint32_t>(i));
+    }
+
+    auto output = std::vector<uint32_t>(CAPACITY);
+
+    BENCHMARK("reduce(seq) over segments()") {
+        return core::ringbuf::reduce(std::execution::seq, buf, uint64_t{0});
+    };
+
+    BENCHMARK("reduce(par_unseq) over segments()") {
+        return core::ringbuf::reduce(std::execution::par_unseq, buf, uint64_t{0});
+    };
+
+    BENCHMARK("transform(seq) of an expensive function over segments()") {
+        return core::ringbuf::transform(std::execution::seq, buf, output.begin(), mix);
+    };
+
+    BENCHMARK("transform(par) of an expensive function over segments()") {
+        return core::ringbuf::transform(std::execution::par, buf, output.begin(), mix);
+    };
+}
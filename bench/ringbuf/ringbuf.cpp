@@ -0,0 +1,139 @@
+/// Benchmarks for RingBuffer.
+
+#include <array>
+#include <ranges>
+
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity>
+using RingBuffer = core::ringbuf::RingBuffer<T, Capacity>;
+
+////////////////////////////////////////////////////////////////
+
+TEST_CASE("Benchmarks") {
+    constexpr auto CAPACITY = 64;
+    auto buf = RingBuffer<uint8_t, CAPACITY>{};
+
+    // Compare the checked functions against the unchecked ones to see what returning
+    // std::expected<..., Error> costs.
+    BENCHMARK("push()") {
+        [[maybe_unused]] auto _ = buf.push(0);
+        return buf.pop_unchecked();
+    };
+
+    BENCHMARK("pop()") {
+        buf.push_unchecked(0);
+        return buf.pop();
+    };
+
+    BENCHMARK("push_unchecked()") {
+        buf.push_unchecked(0);
+        return buf.pop_unchecked();
+    };
+}
+
+TEST_CASE("Capacity benchmarks") {
+    // Power of two capacities use free running indices and masking. 63 takes the generic path.
+    auto pow2 = RingBuffer<uint32_t, 64>{};
+    auto generic = RingBuffer<uint32_t, 63>{};
+
+    BENCHMARK("push()/pop() power of two capacity") {
+        [[maybe_unused]] auto _ = pow2.push(1);
+        return pow2.pop();
+    };
+
+    BENCHMARK("push()/pop() generic capacity") {
+        [[maybe_unused]] auto _ = generic.push(1);
+        return generic.pop();
+    };
+
+    // Fill both to the same level with the contents wrapping the end of the buffer.
+    for (auto i : std::views::iota(0u, 48u)) {
+        [[maybe_unused]] auto _1 = pow2.push(i);
+        [[maybe_unused]] auto _2 = generic.push(i);
+    }
+
+    BENCHMARK("Iterator traversal power of two capacity") {
+        auto sum = uint32_t{0};
+        for (auto iter = pow2.begin(); iter != pow2.end(); iter += 1) sum += *iter;
+        return sum;
+    };
+
+    BENCHMARK("Iterator traversal generic capacity") {
+        auto sum = uint32_t{0};
+        for (auto iter = generic.begin(); iter != generic.end(); iter += 1) sum += *iter;
+        return sum;
+    };
+}
+
+TEST_CASE("Traversal benchmarks") {
+    constexpr auto CAPACITY = 1024;
+
+    auto array = std::array<uint32_t, CAPACITY>{};
+    auto buf = RingBuffer<uint32_t, CAPACITY>{};
+
+    // Start half way through so the contents wrap the end of the storage.
+    for (auto i : std::views::iota(0u, CAPACITY / 2u)) {
+        buf.push_unchecked(i);
+        [[maybe_unused]] auto _ = buf.pop_unchecked();
+    }
+
+    for (auto i : std::views::iota(0u, uint32_t{CAPACITY})) {
+        array[i] = i;
+        buf.push_unchecked(i);
+    }
+
+    BENCHMARK("Raw array traversal") {
+        auto sum = uint32_t{0};
+        for (auto value : array) sum += value;
+        return sum;
+    };
+
+    BENCHMARK("Iterator traversal") {
+        auto sum = uint32_t{0};
+        for (auto value : buf) sum += value;
+        return sum;
+    };
+
+    BENCHMARK("peek_read() traversal") {
+        const auto segments = buf.peek_read();
+
+        auto sum = uint32_t{0};
+        for (auto value : segments.first) sum += value;
+        for (auto value : segments.second) sum += value;
+        return sum;
+    };
+}
+
+TEST_CASE("Batch benchmarks") {
+    constexpr auto CAPACITY = 1024;
+    auto buf = RingBuffer<uint32_t, CAPACITY>{};
+    auto next = uint32_t{0};
+
+    // Transfer the same number of elements one at a time and in a single batch, to show what the
+    // per element index update and std::expected cost.
+    BENCHMARK("push()/pop() loop") {
+        for (auto i = 0; i < CAPACITY; i++) {
+            [[maybe_unused]] auto _ = buf.push(next++);
+        }
+
+        auto sum = uint32_t{0};
+        while (auto value = buf.pop()) sum += *value;
+
+        return sum;
+    };
+
+    BENCHMARK("fill()/drain_all()") {
+        buf.fill(CAPACITY, [&] { return next++; });
+
+        auto sum = uint32_t{0};
+        buf.drain_all([&](const uint32_t value) { sum += value; });
+
+        return sum;
+    };
+}
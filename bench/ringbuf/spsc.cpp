@@ -0,0 +1,83 @@
+/// Benchmarks for SpscRingBuffer.
+
+#include <mutex>
+#include <ranges>
+#include <thread>
+
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "ringbuf.hpp"
+#include "spsc.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity>
+using RingBuffer = core::ringbuf::RingBuffer<T, Capacity>;
+
+template<typename T, size_t Capacity, typename StatsPolicy = core::ringbuf::NoStats>
+using SpscRingBuffer = core::ringbuf::SpscRingBuffer<T, Capacity, StatsPolicy>;
+
+using Error = core::ringbuf::Error;
+
+////////////////////////////////////////////////////////////////
+
+/// RingBuffer guarded by a mutex. Used as the baseline for the SPSC benchmarks.
+template<typename T, size_t Capacity>
+struct LockedRingBuffer {
+    auto push(T value) noexcept -> std::expected<void, Error> {
+        auto lock = std::scoped_lock(this->mutex);
+        return this->buffer.push(value);
+    }
+
+    auto pop() noexcept -> std::expected<T, Error> {
+        auto lock = std::scoped_lock(this->mutex);
+        return this->buffer.pop();
+    }
+
+private:
+    std::mutex mutex{};
+    RingBuffer<T, Capacity> buffer{};
+};
+
+/// Move count values from a producer thread to the calling thread and return their sum.
+template<typename Queue>
+auto transfer(Queue& queue, const uint32_t count) -> uint64_t {
+    auto producer = std::jthread([&] {
+        for (auto i : std::views::iota(uint32_t{0}, count)) {
+            while (!queue.push(i)) continue;
+        }
+    });
+
+    auto sum = uint64_t{0};
+
+    for ([[maybe_unused]] auto i : std::views::iota(uint32_t{0}, count)) {
+        auto value = queue.pop();
+        while (!value) value = queue.pop();
+        sum += *value;
+    }
+
+    return sum;
+}
+
+////////////////////////////////////////////////////////////////
+
+TEST_CASE("SpscRingBuffer benchmarks") {
+    constexpr auto CAPACITY = 1024;
+    constexpr auto COUNT = uint32_t{100'000};
+
+    BENCHMARK_ADVANCED("Mutex guarded RingBuffer transfer")(Catch::Benchmark::Chronometer meter) {
+        auto queue = LockedRingBuffer<uint32_t, CAPACITY>{};
+        meter.measure([&] { return transfer(queue, COUNT); });
+    };
+
+    BENCHMARK_ADVANCED("SpscRingBuffer transfer")(Catch::Benchmark::Chronometer meter) {
+        auto queue = SpscRingBuffer<uint32_t, CAPACITY>{};
+        meter.measure([&] { return transfer(queue, COUNT); });
+    };
+
+    BENCHMARK_ADVANCED("SpscRingBuffer with Stats transfer")(Catch::Benchmark::Chronometer meter) {
+        auto queue = SpscRingBuffer<uint32_t, CAPACITY, core::ringbuf::Stats>{};
+        meter.measure([&] { return transfer(queue, COUNT); });
+    };
+}
@@ -0,0 +1,49 @@
+/// Benchmarks for SlidingWindow.
+
+#include <algorithm>
+
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "overwrite.hpp"
+#include "window.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity>
+using OverwriteRingBuffer = core::ringbuf::OverwriteRingBuffer<T, Capacity>;
+
+template<typename T, size_t Capacity>
+using SlidingWindow = core::ringbuf::SlidingWindow<T, Capacity>;
+
+////////////////////////////////////////////////////////////////
+
+TEST_CASE("SlidingWindow benchmarks") {
+    constexpr auto CAPACITY = 1024;
+
+    BENCHMARK_ADVANCED("OverwriteRingBuffer push and recompute")(
+        Catch::Benchmark::Chronometer meter) {
+        auto buf = OverwriteRingBuffer<double, CAPACITY>{};
+        for (auto i = 0; i < CAPACITY; i++) buf.push(i);
+
+        meter.measure([&](const int i) {
+            buf.push(i);
+
+            auto sum = 0.0;
+            for (const auto sample : buf) sum += sample;
+
+            const auto [min, max] = std::ranges::minmax(buf);
+            return sum + min + max;
+        });
+    };
+
+    BENCHMARK_ADVANCED("SlidingWindow push")(Catch::Benchmark::Chronometer meter) {
+        auto window = SlidingWindow<double, CAPACITY>{};
+        for (auto i = 0; i < CAPACITY; i++) window.push(i);
+
+        meter.measure([&](const int i) {
+            window.push(i);
+            return window.sum() + *window.min() + *window.max();
+        });
+    };
+}
@@ -1,14 +1,23 @@
 #pragma once
 
+#include <algorithm>
+
 #include "error_base.hpp"
 #include "error_variant.hpp"
 
 /// @brief Derive a specialisation of std::formatter for an error type.
 /// 
+/// If FORMAT takes no args it's also stored as the error's MESSAGE, and the formatter copies it
+/// rather than going through std::format_to().
+///
 /// @param ERROR  Error type
 /// @param FORMAT Format specifier. Must be a string literal.
 /// @param ...    Format args. The error object can be accessed as `self`.
 #define ERROR_DERIVE_FMT(ERROR, FORMAT, ...)                                                                  \
+template<>                                                                                                    \
+inline constexpr auto ::error::MESSAGE<ERROR> =                                                               \
+    ::error::message_impl::constant<false __VA_OPT__(|| true)>(FORMAT);                                       \
+                                                                                                              \
 namespace std {                                                                                               \
 template<>                                                                                                    \
 struct formatter<ERROR, char> {                                                                               \
@@ -20,8 +29,11 @@ struct formatter<ERROR, char> {
                                                                                                               \
     template<class FmtContext>                                                                                \
     constexpr auto format([[maybe_unused]]const ERROR& self, FmtContext& ctx) const -> FmtContext::iterator { \
-        std::format_to(ctx.out(), FORMAT __VA_OPT__(,) __VA_ARGS__);                                          \
-        return ctx.out();                                                                                     \
+        if constexpr (::error::MESSAGE<ERROR>.has_value()) {                                                  \
+            return std::ranges::copy(*::error::MESSAGE<ERROR>, ctx.out()).out;                                \
+        } else {                                                                                              \
+            return std::format_to(ctx.out(), FORMAT __VA_OPT__(,) __VA_ARGS__);                               \
+        }                                                                                                     \
     }                                                                                                         \
 };                                                                                                            \
 }
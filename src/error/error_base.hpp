@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <expected>
 #include <format>
 #include <optional>
+#include <string_view>
 
 namespace error {
 
@@ -23,6 +26,40 @@ struct Error {
         -> std::optional<std::reference_wrapper<const Error>> {
         return std::nullopt;
     }
+
+    /// @brief Format the error into out, writing at most n characters.
+    ///
+    /// Lets errors returned by source() be formatted when only their Error base is known. Sources
+    /// reached through a StaticSource are formatted by type instead, so only errors returned by
+    /// other sources need to override this to appear in format_chain_to_n() output.
+    ///
+    /// @return The end of the output and the untruncated size, as std::format_to_n() returns, or
+    ///         nullopt if the error can't be formatted this way.
+    virtual auto format_to_n([[maybe_unused]] char* out,
+                             [[maybe_unused]] std::size_t n) const noexcept
+        -> std::optional<std::format_to_n_result<char*>> {
+        return std::nullopt;
+    }
+};
+
+/// Non-virtual alternative to Error for errors which don't carry a source.
+///
+/// Errors deriving from this stay trivially copyable, as do Variants made only of them, so
+/// std::expected results holding them can be returned in registers. Since they don't derive from
+/// Error they can't be returned by another error's source().
+struct TrivialError {
+    constexpr auto operator==(const TrivialError& other) const noexcept -> bool = default;
+
+    constexpr auto source() const noexcept -> std::optional<std::reference_wrapper<const Error>> {
+        return std::nullopt;
+    }
+
+    /// @brief Never called, since a TrivialError can't be another error's source.
+    auto format_to_n([[maybe_unused]] char* out,
+                     [[maybe_unused]] std::size_t n) const noexcept
+        -> std::optional<std::format_to_n_result<char*>> {
+        return std::nullopt;
+    }
 };
 
 /// Constraint for error types.
@@ -36,4 +73,116 @@ concept ErrorInterface = requires(Self self) {
 template<typename Self>
 concept ErrorType = std::formattable<Self, char> && ErrorInterface<Self>;
 
+/// Requires an error type T to declare the type of error its source() returns as T::Source.
+///
+/// Such a source() must always return a source of that type. It lets the errors reachable from a
+/// Variant be found at compile time, and the source chain walked without virtual calls.
+template<typename T>
+concept StaticSource = requires() { typename T::Source; };
+
+/// Message of an error type whose format takes no arguments, resolved at compile time.
+///
+/// ERROR_DERIVE_FMT() specialises this for every error it derives a formatter for. Errors with a
+/// constant message are formatted by copying it rather than through std::format_to(), and Variants
+/// made only of them can return theirs from message().
+template<typename E>
+inline constexpr auto MESSAGE = std::optional<std::string_view>{};
+
+namespace message_impl {
+
+/// @brief Get the message a format produces, if it's constant.
+///
+/// Formats containing braces are left to std::format, even if they're only escapes.
+template<bool HAS_ARGS>
+consteval auto constant(const std::string_view format) noexcept
+    -> std::optional<std::string_view> {
+    if (HAS_ARGS || format.find_first_of("{}") != std::string_view::npos) {
+        return std::nullopt;
+    }
+
+    return format;
+}
+
+/// @brief Copy message into out, writing at most n characters.
+///
+/// @return The end of the output and the untruncated size, as std::format_to_n() returns.
+constexpr auto copy_to_n(char* const out,
+                         const std::size_t n,
+                         const std::string_view message) noexcept
+    -> std::format_to_n_result<char*> {
+    const auto count = std::min(n, message.size());
+    return {std::copy_n(message.data(), count, out), static_cast<std::ptrdiff_t>(message.size())};
+}
+
+}
+
+namespace chain_impl {
+
+/// @brief Format error into out, writing at most n characters.
+template<ErrorType E>
+auto format_to_n(char* const out, const std::size_t n, const E& error) noexcept
+    -> std::format_to_n_result<char*> {
+    if constexpr (requires { error.message(); }) {
+        return message_impl::copy_to_n(out, n, error.message());
+    } else {
+        return std::format_to_n(out, static_cast<std::ptrdiff_t>(n), "{}", error);
+    }
+}
+
+/// @brief Append ": " and each error in the source chain of error to result, which was written
+///        from out.
+///
+/// StaticSources are followed by type and formatted through their std::formatter. Once the chain
+/// reaches any other source, the rest of it is formatted through Error::format_to_n(), and errors
+/// which don't support that are left out along with their separator.
+template<ErrorType E>
+auto append_sources(char* const out,
+                    const std::size_t n,
+                    std::format_to_n_result<char*> result,
+                    const E& error) noexcept -> std::format_to_n_result<char*> {
+    const auto remaining = [&](char* const end) {
+        return n - static_cast<std::size_t>(end - out);
+    };
+
+    if constexpr (requires { requires ErrorType<typename E::Source>; }) {
+        using Source = E::Source;
+        const auto& source = static_cast<const Source&>(error.E::source()->get());
+
+        const auto separator = message_impl::copy_to_n(result.out, remaining(result.out), ": ");
+        const auto next = chain_impl::format_to_n(separator.out, remaining(separator.out), source);
+
+        result = {next.out, result.size + separator.size + next.size};
+        return append_sources(out, n, result, source);
+    } else {
+        for (auto source = error.source(); source; source = source->get().source()) {
+            const auto separator = message_impl::copy_to_n(result.out, remaining(result.out), ": ");
+            const auto next = source->get().format_to_n(separator.out, remaining(separator.out));
+
+            if (!next) {
+                continue;
+            }
+
+            result = {next->out, result.size + separator.size + next->size};
+        }
+
+        return result;
+    }
+}
+
+}
+
+/// @brief Format error followed by each error in its source() chain, separated by ": ".
+///
+/// At most n characters are written to out and nothing is allocated, so it's safe to use for
+/// logging on hot paths. StaticSources are formatted through their std::formatter, and any other
+/// sources through Error::format_to_n(). Those which don't support it are left out, along with
+/// their separator.
+///
+/// @return The end of the output and the untruncated size, as std::format_to_n() returns.
+template<ErrorType E>
+auto format_chain_to_n(char* const out, const std::size_t n, const E& error) noexcept
+    -> std::format_to_n_result<char*> {
+    return chain_impl::append_sources(out, n, chain_impl::format_to_n(out, n, error), error);
+}
+
 }
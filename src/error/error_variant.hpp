@@ -1,5 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
 #include "error_base.hpp"
 
 namespace error {
@@ -8,31 +16,244 @@ namespace error {
 template<typename T, typename... Ts>
 concept AnyOf = (std::same_as<T, Ts> || ...);
 
-/// Wrapper over std::variant for types implementing ErrorType.
 template<ErrorType... Es>
-struct Variant: Error {
-    friend struct std::formatter<Variant>;
+struct Variant;
+
+/// Requires a type T to be a Variant or derive from one, naming it as T::Variant.
+template<typename T>
+concept VariantDerivative = requires() {
+    typename T::Variant;
+    requires std::derived_from<T, typename T::Variant>;
+};
+
+namespace variant_impl {
+
+template<typename... Ts>
+struct List {};
+
+template<typename V>
+struct Alternatives;
+
+template<typename... Es>
+struct Alternatives<Variant<Es...>> {
+    using type = List<Es...>;
+};
+
+/// Append E and every error reachable from it to L, skipping those already in L.
+template<typename L, typename E>
+struct Reach;
+
+template<typename L, typename Es>
+struct ReachAll;
+
+template<typename L>
+struct ReachAll<L, List<>> {
+    using type = L;
+};
+
+template<typename L, typename E, typename... Es>
+struct ReachAll<L, List<E, Es...>> {
+    using type = ReachAll<typename Reach<L, E>::type, List<Es...>>::type;
+};
+
+template<typename... Ls, typename E>
+struct Reach<List<Ls...>, E> {
+    using type = decltype([] {
+        if constexpr (VariantDerivative<E>) {
+            return typename ReachAll<List<Ls...>,
+                                     typename Alternatives<typename E::Variant>::type>::type{};
+        } else if constexpr (AnyOf<E, Ls...>) {
+            return List<Ls...>{};
+        } else if constexpr (StaticSource<E>) {
+            return typename Reach<List<Ls..., E>, typename E::Source>::type{};
+        } else {
+            return List<Ls..., E>{};
+        }
+    }());
+};
+
+
+template<typename T, typename... Ts>
+consteval auto index_of() noexcept -> uint8_t {
+    constexpr bool MATCHES[] = {std::same_as<T, Ts>...};
+
+    for (auto i = size_t{0}; i < sizeof...(Ts); i++) {
+        if (MATCHES[i]) return static_cast<uint8_t>(i);
+    }
+
+    return sizeof...(Ts);
+}
+
+template<typename E, typename... Ls>
+consteval auto code_in(List<Ls...> /*unused*/) noexcept -> uint8_t {
+    return index_of<E, Ls...>();
+}
+
+template<typename L, typename E>
+constexpr auto code_of(const E& error) noexcept -> uint8_t;
 
+template<typename L, typename E>
+constexpr auto chain_of(const E& error) noexcept -> uint64_t;
+
+/// Whether every error an error type can hold has a constant MESSAGE.
+template<typename E>
+inline constexpr auto HAS_MESSAGE = MESSAGE<E>.has_value();
+
+template<VariantDerivative E>
+inline constexpr auto HAS_MESSAGE<E> = E::Variant::CONSTANT_MESSAGES;
+
+/// Message of each stateless variant, indexed by its discriminant.
+template<typename... Es>
+inline constexpr std::string_view MESSAGES[] = {*MESSAGE<Es>...};
+
+template<typename E>
+constexpr auto message_of(const E& error) noexcept -> std::string_view;
+
+template<typename... Es>
+inline constexpr auto STATELESS = sizeof...(Es) <= UINT8_MAX && (std::is_empty_v<Es> && ...) &&
+                                  (std::is_trivially_default_constructible_v<Es> && ...);
+
+template<typename V>
+auto format_to_n(const V& variant, char* out, size_t n) noexcept -> std::format_to_n_result<char*>;
+
+/// Base of a Variant V, implementing the members of Error or TrivialError on its behalf.
+///
+/// It's a separate class so that they're only marked override when they do override Error.
+template<typename V, bool TRIVIAL>
+struct Base;
+
+template<typename V>
+struct Base<V, true>: TrivialError {
+    /// @brief Return the source of the error if any.
+    ///
+    /// @return The source of the error or nullopt.
+    constexpr auto source() const noexcept -> std::optional<std::reference_wrapper<const Error>> {
+        return static_cast<const V&>(*this).visit([](const auto& error) { return error.source(); });
+    }
+
+    /// @brief Format the held error into out, writing at most n characters.
+    ///
+    /// @return The end of the output and the untruncated size, as std::format_to_n() returns.
+    ///         Never nullopt, since every alternative is formattable.
+    auto format_to_n(char* const out, const std::size_t n) const noexcept
+        -> std::optional<std::format_to_n_result<char*>> {
+        return variant_impl::format_to_n(static_cast<const V&>(*this), out, n);
+    }
+};
+
+template<typename V>
+struct Base<V, false>: Error {
+    /// @brief Return the source of the error if any.
+    ///
+    /// @return The source of the error or nullopt.
+    constexpr auto source() const noexcept
+        -> std::optional<std::reference_wrapper<const Error>> override {
+        return static_cast<const V&>(*this).visit([](const auto& error) { return error.source(); });
+    }
+
+    /// @brief Format the held error into out, writing at most n characters.
+    ///
+    /// @return The end of the output and the untruncated size, as std::format_to_n() returns.
+    ///         Never nullopt, since every alternative is formattable.
+    auto format_to_n(char* const out, const std::size_t n) const noexcept
+        -> std::optional<std::format_to_n_result<char*>> override {
+        return variant_impl::format_to_n(static_cast<const V&>(*this), out, n);
+    }
+};
+
+}
+
+/// Wrapper over std::variant for types implementing ErrorType.
+///
+/// If every variant is trivially copyable the Variant derives from TrivialError rather than Error,
+/// so it's trivially copyable too. If every variant is also an empty tag type, only a uint8_t
+/// discriminant is stored, and is(), get() and visit() switch on it directly. Such a Variant has no
+/// state to modify, so it has no get_mut(), and visit_mut() passes the visitor a fresh copy.
+template<ErrorType... Es>
+struct Variant: variant_impl::Base<Variant<Es...>, (std::is_trivially_copyable_v<Es> && ...)> {
 private:
-    std::variant<Es...> inner{};
+    static constexpr auto STATELESS = variant_impl::STATELESS<Es...>;
+
+    template<typename E>
+    static constexpr auto INDEX = variant_impl::index_of<E, Es...>();
+
+    template<size_t I>
+    using Alternative = std::variant_alternative_t<I, std::variant<Es...>>;
+
+    /// The value of every stateless variant, for get() and visit() to refer to.
+    template<typename E>
+    static constexpr auto INSTANCE = E{};
+
+    std::conditional_t<STATELESS, uint8_t, std::variant<Es...>> inner{};
+
+    template<size_t I, bool MUTABLE, typename Visitor>
+    static constexpr auto visit_stateless(uint8_t index, Visitor&& visitor) noexcept
+        -> decltype(auto);
 
 public:
-    constexpr Variant(const AnyOf<Es...> auto& error) noexcept : inner{error} {}
+    /// Every error type reachable from this Variant, through nested Variants and StaticSources, in
+    /// the order they're first found.
+    using Reachable = variant_impl::ReachAll<variant_impl::List<>, variant_impl::List<Es...>>::type;
+
+    /// Numeric code of an error type reachable from this Variant. It's stable for as long as the
+    /// declarations the Variant is built from keep their order.
+    template<typename E>
+    static constexpr auto CODE = variant_impl::code_in<E>(Reachable{});
+
+    /// Whether an error type is reachable from this Variant.
+    template<typename E>
+    static constexpr auto REACHABLE = CODE<E> != CODE<void>;
+
+    /// Whether every error this Variant can hold has a constant MESSAGE, making message() available
+    /// and letting it be formatted without std::format_to().
+    static constexpr auto CONSTANT_MESSAGES = (variant_impl::HAS_MESSAGE<Es> && ...);
+
+    constexpr Variant(const AnyOf<Es...> auto& error) noexcept : inner{make(error)} {}
 
     constexpr auto operator==(const AnyOf<Es...> auto& other) const noexcept -> bool {
         if (!this->is<typename std::decay<decltype(other)>::type>()) {
             return false;
         }
 
-        return std::get<typename std::decay<decltype(other)>::type>(this->inner) == other;
+        return this->get<typename std::decay<decltype(other)>::type>()->get() == other;
     }
 
-    /// @brief Return the source of the error if any.
+    /// @brief Get the code of the held error, looking through nested Variants.
+    constexpr auto code() const noexcept -> uint8_t {
+        return variant_impl::code_of<Reachable>(*this);
+    }
+
+    /// @brief Get the codes of the held error and every error in its source chain.
     ///
-    /// @return The source of the error or nullopt.
-    constexpr auto source() const noexcept
-        -> std::optional<std::reference_wrapper<const Error>> override {
-        return std::visit([](const auto& error) { return error.source(); }, this->inner);
+    /// Sources are only followed through StaticSources, so if every error in the chain is one
+    /// and there are no nested Variants, this is a lookup on the held variant.
+    ///
+    /// @return A mask with bit CODE<E> set for each error E in the chain.
+    constexpr auto chain() const noexcept -> uint64_t {
+        return variant_impl::chain_of<Reachable>(*this);
+    }
+
+    /// @brief Determine if the held error or any error in its source chain is E.
+    template<typename E>
+    constexpr auto contains() const noexcept -> bool {
+        if constexpr (REACHABLE<E>) {
+            return ((this->chain() >> CODE<E>) & 1) != 0;
+        } else {
+            return false;
+        }
+    }
+
+    /// @brief Get the message of the held error, looking through nested Variants.
+    ///
+    /// If the Variant is stateless this is a lookup on its discriminant.
+    constexpr auto message() const noexcept -> std::string_view
+        requires CONSTANT_MESSAGES
+    {
+        if constexpr (STATELESS) {
+            return variant_impl::MESSAGES<Es...>[this->inner];
+        } else {
+            return this->visit([](const auto& error) { return variant_impl::message_of(error); });
+        }
     }
 
     /// @brief Get a reference to the inner error variant of the given type.
@@ -40,19 +261,25 @@ public:
     /// @return The variant if the specified type is held. Returns nullopt otherwise.
     template<AnyOf<Es...> E>
     constexpr auto get() const noexcept -> std::optional<std::reference_wrapper<const E>> {
-        if (!std::holds_alternative<E>(this->inner)) {
+        if (!this->is<E>()) {
             return std::nullopt;
         }
 
-        return std::get<E>(this->inner);
+        if constexpr (STATELESS) {
+            return std::cref(INSTANCE<E>);
+        } else {
+            return std::get<E>(this->inner);
+        }
     }
 
     /// @brief Get a mutable reference to the inner error variant of the given type.
     ///
     /// @return The variant if the specified type is held. Returns nullopt otherwise.
     template<AnyOf<Es...> E>
-    constexpr auto get_mut() noexcept -> std::optional<std::reference_wrapper<E>> {
-        if (!std::holds_alternative<E>(this->inner)) {
+    constexpr auto get_mut() noexcept -> std::optional<std::reference_wrapper<E>>
+        requires(!STATELESS)
+    {
+        if (!this->is<E>()) {
             return std::nullopt;
         }
 
@@ -62,30 +289,127 @@ public:
     /// @brief Determine if the error is the given variant.
     template<AnyOf<Es...> E>
     constexpr auto is() const noexcept -> bool {
-        return std::holds_alternative<E>(this->inner);
+        if constexpr (STATELESS) {
+            return this->inner == INDEX<E>;
+        } else {
+            return std::holds_alternative<E>(this->inner);
+        }
     }
 
     /// @brief Call the provided invokable on the error variant.
     template<typename Visitor>
         requires(std::invocable<Visitor, Es> && ...)
     constexpr auto visit(Visitor&& visitor) const noexcept -> decltype(auto) {
-        return std::visit(std::forward<decltype(visitor)>(visitor), this->inner);
+        if constexpr (STATELESS) {
+            return visit_stateless<0, false>(this->inner, std::forward<decltype(visitor)>(visitor));
+        } else {
+            return std::visit(std::forward<decltype(visitor)>(visitor), this->inner);
+        }
     }
 
     /// @brief Call the provided invokable on the error variant.
     template<typename Visitor>
         requires(std::invocable<Visitor, Es> && ...)
     constexpr auto visit_mut(Visitor&& visitor) noexcept -> decltype(auto) {
-        return std::visit(std::forward<decltype(visitor)>(visitor), this->inner);
+        if constexpr (STATELESS) {
+            return visit_stateless<0, true>(this->inner, std::forward<decltype(visitor)>(visitor));
+        } else {
+            return std::visit(std::forward<decltype(visitor)>(visitor), this->inner);
+        }
     }
-};
 
-template<typename T>
-concept VariantDerivative = requires() {
-    typename T::Variant;
-    requires std::derived_from<T, typename T::Variant>;
+private:
+    template<typename E>
+    static constexpr auto make(const E& error) noexcept -> decltype(inner) {
+        if constexpr (STATELESS) {
+            return INDEX<E>;
+        } else {
+            return error;
+        }
+    }
 };
 
+/*------------------------------------------------------------------------------------------------*/
+
+/// Call visitor with the stateless variant at index, as a chain of comparisons which the compiler
+/// turns into a switch or jump table.
+template<ErrorType... Es>
+template<size_t I, bool MUTABLE, typename Visitor>
+constexpr auto Variant<Es...>::visit_stateless(const uint8_t index, Visitor&& visitor) noexcept
+    -> decltype(auto) {
+    // A mutable visitor gets a copy of its own, so nothing it does is seen by other Variants.
+    [[maybe_unused]] auto copy = Alternative<I>{};
+    auto& error = [&] -> auto& {
+        if constexpr (MUTABLE) {
+            return copy;
+        } else {
+            return INSTANCE<Alternative<I>>;
+        }
+    }();
+
+    if constexpr (I + 1 == sizeof...(Es)) {
+        return std::invoke(std::forward<Visitor>(visitor), error);
+    } else {
+        if (index == I) {
+            return std::invoke(std::forward<Visitor>(visitor), error);
+        }
+
+        return visit_stateless<I + 1, MUTABLE>(index, std::forward<Visitor>(visitor));
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename V>
+auto variant_impl::format_to_n(const V& variant, char* const out, const size_t n) noexcept
+    -> std::format_to_n_result<char*> {
+    if constexpr (V::CONSTANT_MESSAGES) {
+        return message_impl::copy_to_n(out, n, variant.message());
+    } else {
+        return variant.visit([&](const auto& error) {
+            return std::format_to_n(out, static_cast<std::ptrdiff_t>(n), "{}", error);
+        });
+    }
+}
+
+template<typename E>
+constexpr auto variant_impl::message_of(const E& error) noexcept -> std::string_view {
+    if constexpr (VariantDerivative<E>) {
+        return error.message();
+    } else {
+        return *MESSAGE<E>;
+    }
+}
+
+template<typename L, typename E>
+constexpr auto variant_impl::code_of(const E& error) noexcept -> uint8_t {
+    if constexpr (VariantDerivative<E>) {
+        return error.visit([](const auto& inner) { return code_of<L>(inner); });
+    } else {
+        return code_in<E>(L{});
+    }
+}
+
+/// Source chains are walked by calling each StaticSource's own source() rather than through the
+/// virtual Error::source(), so when the chain's types are all known the calls fold away.
+template<typename L, typename E>
+constexpr auto variant_impl::chain_of(const E& error) noexcept -> uint64_t {
+    if constexpr (VariantDerivative<E>) {
+        return error.visit([](const auto& inner) { return chain_of<L>(inner); });
+    } else {
+        static_assert(code_in<void>(L{}) <= 64, "Too many reachable errors for a chain mask");
+
+        auto mask = uint64_t{1} << code_in<E>(L{});
+
+        if constexpr (StaticSource<E>) {
+            using Source = E::Source;
+            mask |= chain_of<L>(static_cast<const Source&>(error.E::source()->get()));
+        }
+
+        return mask;
+    }
+}
+
 }
 
 namespace std {
@@ -98,10 +422,14 @@ struct formatter<error::Variant<Ts...>, char> {
     }
 
     template<class FmtContext>
-    constexpr auto format(error::Variant<Ts...> error, FmtContext& ctx) const
+    constexpr auto format(const error::Variant<Ts...>& error, FmtContext& ctx) const
         -> FmtContext::iterator {
-        std::visit([&](auto& inner) { std::format_to(ctx.out(), "{}", inner); }, error.inner);
-        return ctx.out();
+        if constexpr (error::Variant<Ts...>::CONSTANT_MESSAGES) {
+            return std::ranges::copy(error.message(), ctx.out()).out;
+        } else {
+            return error.visit(
+                [&](const auto& inner) { return std::format_to(ctx.out(), "{}", inner); });
+        }
     }
 };
 
@@ -113,9 +441,13 @@ struct formatter<T, char> {
     }
 
     template<class FmtContext>
-    constexpr auto format(T error, FmtContext& ctx) const -> FmtContext::iterator {
-        std::visit([&](auto& inner) { std::format_to(ctx.out(), "{}", inner); }, error.inner);
-        return ctx.out();
+    constexpr auto format(const T& error, FmtContext& ctx) const -> FmtContext::iterator {
+        if constexpr (T::Variant::CONSTANT_MESSAGES) {
+            return std::ranges::copy(error.message(), ctx.out()).out;
+        } else {
+            return error.visit(
+                [&](const auto& inner) { return std::format_to(ctx.out(), "{}", inner); });
+        }
     }
 };
 
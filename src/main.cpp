@@ -23,6 +23,8 @@ struct Error2: error::Error {
 struct Error3 {
     friend struct std::formatter<Error3>;
 
+    using Source = Error2;
+
 private:
     Error2 inner{};
 
@@ -54,6 +56,8 @@ static_assert(error::ErrorType<Error2>);
 static_assert(error::ErrorType<Error3>);
 static_assert(error::ErrorType<Error>);
 
+static_assert(Error::CODE<Error3> == 2);
+
 ////////////////////////////////////////////////////////////////
 
 template<typename... Ts>
@@ -1,20 +1,322 @@
-#include <iostream>
+#if __has_include(<unistd.h>)
+    #include <cerrno>
+    #include <unistd.h>
+#else
+    #include <cstdio>
+#endif
+
+#if __has_include(<unwind.h>)
+    #include <unwind.h>
+#endif
+
+#if defined(__unix__)
+    #include <csignal>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <thread>
 
 #include "panic.hpp"
 
+#if defined(__linux__)
+/// Start of the executable's mapping, provided by the GNU linkers.
+extern "C" const char __executable_start;
+#endif
+
 namespace {
-auto out_stream = std::optional<std::ostream_iterator<char>>{};
+
+/// Write message to stderr with as few syscalls as possible, without touching std::cerr or stdio
+/// state which may be locked or corrupted by the time we panic.
+auto write_stderr(std::span<const char> message) noexcept -> void {
+#if __has_include(<unistd.h>)
+    while (!message.empty()) {
+        const auto written = ::write(STDERR_FILENO, message.data(), message.size());
+
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+
+        message = message.subspan(static_cast<std::size_t>(written));
+    }
+#else
+    std::fwrite(message.data(), 1, message.size(), stderr);
+#endif
+}
+
+constinit auto sink = std::atomic<panic_impl::Sink>{&write_stderr};
+
+constinit auto buffer_claimed = std::atomic_flag{};
+constinit auto reported = std::atomic<bool>{};
+
+/// Longest a panic waits for another thread's panic to be reported.
+constexpr auto REPORT_TIMEOUT = std::chrono::seconds{2};
+
+/// Whether this thread claimed the buffer, so that it doesn't wait on its own report.
+constinit thread_local auto claimed_here = false;
+constinit char buffer[panic_impl::BUFFER_SIZE + panic_impl::BACKTRACE_SIZE]{};
+
+/// Return addresses of the last backtrace.
+constexpr auto FRAMES_SIZE = panic_impl::BACKTRACE_DEPTH > 0 ? panic_impl::BACKTRACE_DEPTH : 1;
+constinit std::uintptr_t frames[FRAMES_SIZE]{};
+
+/// Appends text to a buffer, silently truncating, without allocating or touching the locale, so
+/// that it's safe to use from a signal handler.
+struct Writer {
+    auto text(const std::string_view text) noexcept -> Writer& {
+        for (const auto c : text) {
+            if (this->size == this->buffer.size()) break;
+            this->buffer[this->size++] = c;
+        }
+
+        return *this;
+    }
+
+    auto hex(const std::uintptr_t value) noexcept -> Writer& {
+        constexpr auto DIGITS = std::string_view{"0123456789abcdef"};
+        char digits[2 * sizeof(value)]{};
+
+        for (auto i = sizeof(digits); i > 0; i--) {
+            digits[i - 1] = DIGITS[(value >> (4 * (sizeof(digits) - i))) & 0xF];
+        }
+
+        return this->text("0x").text(std::string_view{digits, sizeof(digits)});
+    }
+
+    auto decimal(std::size_t value) noexcept -> Writer& {
+        char digits[20]{};
+        auto count = std::size_t{0};
+
+        do {
+            digits[sizeof(digits) - ++count] = static_cast<char>('0' + (value % 10));
+            value /= 10;
+        } while (value != 0);
+
+        return this->text(std::string_view{digits + sizeof(digits) - count, count});
+    }
+
+    std::span<char> buffer{};
+    std::size_t size{};
+};
+
+#if __has_include(<unwind.h>)
+struct Trace {
+    std::size_t skip{};
+    std::size_t size{};
+};
+
+auto record_frame(_Unwind_Context* const context, void* const argument) -> _Unwind_Reason_Code {
+    auto& trace = *static_cast<Trace*>(argument);
+    const auto address = static_cast<std::uintptr_t>(_Unwind_GetIP(context));
+
+    if (address == 0) {
+        return _URC_END_OF_STACK;
+    }
+
+    if (trace.skip > 0) {
+        trace.skip--;
+        return _URC_NO_REASON;
+    }
+
+    frames[trace.size++] = address;
+    return trace.size == panic_impl::BACKTRACE_DEPTH ? _URC_END_OF_STACK : _URC_NO_REASON;
+}
+#endif
+
+/// Record the return addresses of the caller's stack into frames.
+///
+/// _Unwind_Backtrace() is linked directly rather than loaded on first use, as glibc's backtrace()
+/// is, but it isn't async-signal-safe. Finding the unwind tables walks the loaded objects under the
+/// dynamic loader's lock, and the first call may allocate while it caches them. Calling it once
+/// from install_signal_handlers() takes care of the allocation. A signal which interrupts a thread
+/// holding the loader lock, such as one in dlopen(), can still deadlock the handler, and a
+/// corrupted stack can fault while it's unwound, which kills the process without a report.
+[[gnu::noinline]] auto capture_frames() noexcept -> std::size_t {
+#if __has_include(<unwind.h>)
+    if constexpr (panic_impl::BACKTRACE_DEPTH > 0) {
+        // Skip this function and write_backtrace().
+        auto trace = Trace{.skip = 2};
+        _Unwind_Backtrace(&record_frame, &trace);
+
+        return trace.size;
+    }
+#endif
+
+    return 0;
 }
 
-constexpr auto panic_impl::set_output_stream(const std::ostream_iterator<char>& output) noexcept
-    -> void {
-    out_stream = output;
+#if defined(__unix__)
+constexpr int FATAL_SIGNALS[] = {SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL};
+
+auto signal_name(const int signal) noexcept -> std::string_view {
+    switch (signal) {
+        case SIGSEGV: return "SIGSEGV";
+        case SIGABRT: return "SIGABRT";
+        case SIGBUS: return "SIGBUS";
+        case SIGFPE: return "SIGFPE";
+        case SIGILL: return "SIGILL";
+        default: return "signal";
+    }
 }
 
-auto panic_impl::get_output_stream() noexcept -> std::ostream_iterator<char> {
-    if (out_stream) {
-        return out_stream.value();
+/// Stack for the handlers, so a stack overflow can still be reported.
+alignas(16) constinit char signal_stack[64 * 1024]{};
+
+/// Report a fatal signal through the panic sink, then let it kill the process as it would have.
+///
+/// If a panic is already under way it'll have claimed the buffer, which is usually the case for
+/// the SIGABRT raised when the panic terminates, so nothing more is written. If that panic is on
+/// another thread, its report is waited for first.
+auto handle_signal(const int signal, siginfo_t* const info, void* /*context*/) -> void {
+    if (const auto message = panic_impl::claim_buffer(); !message.empty()) {
+        auto writer = Writer{message.first(panic_impl::BUFFER_SIZE)};
+        writer.text("panic!: ").text(signal_name(signal));
+
+        if (signal == SIGSEGV || signal == SIGBUS) {
+            writer.text(" at ").hex(reinterpret_cast<std::uintptr_t>(info->si_addr));
+        }
+
+        writer.text("\r\n");
+
+        const auto size = writer.size + panic_impl::write_backtrace(message.subspan(writer.size));
+        panic_impl::report(message.first(size));
+    } else {
+        panic_impl::wait_for_report();
+    }
+
+    // SA_RESETHAND has already restored the default action.
+    ::raise(signal);
+}
+#endif
+
+}
+
+auto panic_impl::set_sink(const Sink sink) noexcept -> void {
+    ::sink.store(sink, std::memory_order_release);
+}
+
+auto panic_impl::get_sink() noexcept -> Sink {
+    return ::sink.load(std::memory_order_acquire);
+}
+
+/// @brief Claim the static panic buffer.
+///
+/// @return The buffer, or an empty span if it's already been claimed.
+auto panic_impl::claim_buffer() noexcept -> std::span<char> {
+    if (buffer_claimed.test_and_set(std::memory_order_acquire)) {
+        return {};
+    }
+
+    claimed_here = true;
+    return buffer;
+}
+
+/// @brief Pass the message in the claimed buffer to the sink, then release any waiting panics.
+auto panic_impl::report(const std::span<const char> message) noexcept -> void {
+    get_sink()(message);
+
+    reported.store(true, std::memory_order_release);
+}
+
+/// @brief Wait for the panic which claimed the buffer to be reported, unless it's on this thread.
+///
+/// Stops a panic on another thread from terminating the process before the first one's message
+/// has been written. A panic nested within the one being reported on this thread returns at
+/// once, since waiting would never finish. The wait is bounded by REPORT_TIMEOUT in case the sink
+/// never returns, and only spins and reads the clock, so it's safe in a signal handler.
+auto panic_impl::wait_for_report() noexcept -> void {
+    if (claimed_here) {
+        return;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + REPORT_TIMEOUT;
+
+    while (!reported.load(std::memory_order_acquire)) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return;
+        }
+
+        std::this_thread::yield();
+    }
+}
+
+/// @brief Capture the caller's backtrace and write it to buffer as text.
+///
+/// Only raw return addresses are recorded, into a static array, and no debug info is read. The
+/// unwinder itself may lock or allocate though, so see capture_frames() for what that means in a
+/// signal handler. Symbolise the addresses later, for example with `addr2line -f -C -e
+/// <executable>`. On Linux the executable's load address is written first, so addresses within
+/// the executable can be turned into offsets when it's position independent. The addresses are
+/// return addresses, so each points just after its call.
+///
+/// Writes nothing when PANIC_BACKTRACE_DEPTH is 0 or unwinding isn't supported.
+///
+/// @return The number of characters written.
+auto panic_impl::write_backtrace(const std::span<char> buffer) noexcept -> std::size_t {
+    const auto count = capture_frames();
+    if (count == 0) {
+        return 0;
+    }
+
+    auto writer = Writer{buffer};
+    writer.text("backtrace");
+
+#if defined(__linux__)
+    writer.text(" (executable at ").hex(reinterpret_cast<std::uintptr_t>(&__executable_start));
+    writer.text(")");
+#endif
+
+    writer.text(":\r\n");
+
+    for (auto i = std::size_t{0}; i < count; i++) {
+        writer.text("  #").decimal(i).text(" ").hex(frames[i]).text("\r\n");
+    }
+
+    return writer.size;
+}
+
+/// @brief Report SIGSEGV, SIGABRT, SIGBUS, SIGFPE and SIGILL through the panic sink.
+///
+/// Each signal is written as a panic message, followed by a backtrace if enabled, and then raised
+/// again with its default action so the process still dies, or dumps core, as it would have. The
+/// handlers run on an alternate signal stack, which is only set up for the calling thread, so a
+/// stack overflow on another thread may not be reported. The unwinder is warmed up here so that a
+/// backtrace from a handler doesn't allocate, but it's still not strictly async-signal-safe, so a
+/// handler can occasionally hang or fault while capturing one.
+///
+/// @return false if the handlers couldn't be installed or the platform doesn't have signals.
+auto panic_impl::install_signal_handlers() noexcept -> bool {
+#if defined(__unix__)
+    // Unwinding may allocate while it caches its tables on first use, so do that now rather than
+    // inside a handler.
+    if constexpr (BACKTRACE_DEPTH > 0) {
+        static_cast<void>(capture_frames());
+    }
+
+    auto stack = stack_t{};
+    stack.ss_sp = signal_stack;
+    stack.ss_size = sizeof(signal_stack);
+
+    if (::sigaltstack(&stack, nullptr) != 0) {
+        return false;
+    }
+
+    struct sigaction action{};
+    action.sa_sigaction = &handle_signal;
+    action.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_RESETHAND;
+    sigemptyset(&action.sa_mask);
+
+    for (const auto signal : FATAL_SIGNALS) {
+        if (::sigaction(signal, &action, nullptr) != 0) {
+            return false;
+        }
     }
 
-    return std::ostream_iterator<char>{std::cerr};
+    return true;
+#else
+    return false;
+#endif
 }
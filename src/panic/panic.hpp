@@ -1,6 +1,18 @@
+#include <algorithm>
+#include <cstddef>
+#include <exception>
 #include <format>
-#include <iterator>
 #include <source_location>
+#include <span>
+#include <utility>
+
+#ifndef PANIC_BUFFER_SIZE
+    #define PANIC_BUFFER_SIZE 256
+#endif
+
+#ifndef PANIC_BACKTRACE_DEPTH
+    #define PANIC_BACKTRACE_DEPTH 0
+#endif
 
 namespace panic_impl {
 
@@ -14,6 +26,17 @@ constexpr auto BEHAVIOUR = Behaviour::Halt;
 constexpr auto BEHAVIOUR = Behaviour::Terminate;
 #endif
 
+/// Size of the static buffer panic messages are formatted into. Longer messages are truncated.
+constexpr auto BUFFER_SIZE = std::size_t{PANIC_BUFFER_SIZE};
+
+static_assert(BUFFER_SIZE > 2, "The panic buffer must at least fit the line ending");
+
+/// Maximum number of return addresses recorded when panicking. 0 disables backtraces.
+constexpr auto BACKTRACE_DEPTH = std::size_t{PANIC_BACKTRACE_DEPTH};
+
+/// Space after the message for the backtrace: a header line, then one line per frame.
+constexpr auto BACKTRACE_SIZE = BACKTRACE_DEPTH == 0 ? 0 : 64 + (BACKTRACE_DEPTH * 32);
+
 template<typename... Args>
 struct Format {
     template<typename T>
@@ -26,23 +49,61 @@ struct Format {
     std::source_location loc;
 };
 
-constexpr auto set_output_stream(const std::ostream_iterator<char>& output) noexcept -> void;
-auto get_output_stream() noexcept -> std::ostream_iterator<char>;
+/// Writes a formatted panic message somewhere, e.g. a UART in PANIC_BEHAVIOUR_HALT builds.
+///
+/// It's called at most once, with the whole message. It mustn't allocate, lock or panic, and once
+/// `install_signal_handlers()` has been called it must only make async-signal-safe calls.
+using Sink = auto (*)(std::span<const char> message) noexcept -> void;
+
+auto set_sink(Sink sink) noexcept -> void;
+auto get_sink() noexcept -> Sink;
+
+auto claim_buffer() noexcept -> std::span<char>;
+auto report(std::span<const char> message) noexcept -> void;
+auto wait_for_report() noexcept -> void;
+
+auto write_backtrace(std::span<char> buffer) noexcept -> std::size_t;
+
+auto install_signal_handlers() noexcept -> bool;
 
 };
 
-/// @brief Print a message to the stderr stream and terminate.
+/// @brief Print a message to the panic sink and terminate.
+///
+/// The message is formatted into a static buffer and passed to the sink in one go. By default the
+/// sink writes it straight to stderr's file descriptor, bypassing std::cerr. It can be replaced
+/// via `set_sink()`. Additionally the termination behaviour can be selected via the
+/// `PANIC_BEHAVIOUR_*` flags at compile time.
 ///
-/// The stream used to print the panic message can be set via `set_output_stream()`. Additionally
-/// the termination behaviour can be selected via the `PANIC_BEHAVIOUR_*` flags at compile time.
+/// Defining `PANIC_BACKTRACE_DEPTH` appends up to that many raw return addresses to the message.
+/// See `write_backtrace()`.
 template<typename... Args>
 [[noreturn]] auto panic(panic_impl::Format<std::type_identity_t<Args>...> fmt,
                         Args&&... args) noexcept -> void {
-    auto out = panic_impl::get_output_stream();
+    // Only the first panic gets the buffer, so it needs no lock. Panics on other threads wait for
+    // it to be reported before terminating, while those from within the formatting below go
+    // straight to terminating.
+    if (const auto buffer = panic_impl::claim_buffer(); !buffer.empty()) {
+        // The buffer is sized by panic.cpp's PANIC_BUFFER_SIZE, which needn't match this one's.
+        const auto size = std::min(panic_impl::BUFFER_SIZE, buffer.size());
+        auto* const end = buffer.data() + size - 2;
+        auto* out = buffer.data();
 
-    std::format_to(out, "{}:{} panic!: ", fmt.loc.file_name(), fmt.loc.line());
-    std::format_to(out, fmt.fmt, std::forward<Args>(args)...);
-    std::format_to(out, "\r\n");
+        const auto& loc = fmt.loc;
+        out = std::format_to_n(out, end - out, "{}:{} panic!: ", loc.file_name(), loc.line()).out;
+        out = std::format_to_n(out, end - out, fmt.fmt, std::forward<Args>(args)...).out;
+
+        *out++ = '\r';
+        *out++ = '\n';
+
+        if constexpr (panic_impl::BACKTRACE_DEPTH > 0) {
+            out += panic_impl::write_backtrace(std::span<char>{out, buffer.data() + buffer.size()});
+        }
+
+        panic_impl::report(std::span<const char>{buffer.data(), out});
+    } else {
+        panic_impl::wait_for_report();
+    }
 
     using panic_impl::Behaviour;
 
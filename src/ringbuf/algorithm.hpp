@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "segments.hpp"
+
+namespace core::ringbuf {
+
+namespace algorithm_impl {
+
+template<typename T>
+inline constexpr auto IS_SEGMENTS = false;
+
+template<typename T>
+inline constexpr auto IS_SEGMENTS<Segments<T>> = true;
+
+}
+
+/// A range that can expose its contents in order as Segments, via a segments() member.
+///
+/// The algorithms below run over each segment as a plain span, so unlike the equivalent std::ranges
+/// algorithms over Iterator they don't pay for wrap handling on every element and can be
+/// vectorised. They take part in argument dependent lookup, so an unqualified call such as
+/// `accumulate(buffer, 0)` finds them for the buffers in this namespace.
+template<typename R>
+concept SegmentedRange = requires(R& range) {
+    requires algorithm_impl::IS_SEGMENTS<decltype(range.segments())>;
+};
+
+/// @brief Call function with each element of range in order.
+///
+/// @return function.
+template<SegmentedRange R, typename F>
+constexpr auto for_each(R&& range, F function) -> F {
+    const auto segments = range.segments();
+
+    for (auto& element : segments.first) function(element);
+    for (auto& element : segments.second) function(element);
+
+    return function;
+}
+
+/// @brief Copy the elements of range in order to output.
+///
+/// @return An iterator one past the last element written.
+template<SegmentedRange R, std::weakly_incrementable O>
+constexpr auto copy(R&& range, O output) -> O {
+    const auto segments = range.segments();
+
+    output = std::copy(segments.first.begin(), segments.first.end(), std::move(output));
+    return std::copy(segments.second.begin(), segments.second.end(), std::move(output));
+}
+
+/// @brief Left fold the elements of range onto init using operation.
+template<SegmentedRange R, typename T, typename Op = std::plus<>>
+constexpr auto accumulate(R&& range, T init, Op operation = {}) -> T {
+    const auto segments = range.segments();
+
+    for (const auto& element : segments.first) init = operation(std::move(init), element);
+    for (const auto& element : segments.second) init = operation(std::move(init), element);
+
+    return init;
+}
+
+/// @brief Count the elements of range for which predicate returns true.
+template<SegmentedRange R, typename P>
+constexpr auto count_if(R&& range, P predicate) -> size_t {
+    const auto segments = range.segments();
+    auto count = size_t{0};
+
+    for (const auto& element : segments.first) count += predicate(element) ? 1 : 0;
+    for (const auto& element : segments.second) count += predicate(element) ? 1 : 0;
+
+    return count;
+}
+
+/// @brief Assign value to every element of range.
+template<SegmentedRange R, typename T>
+constexpr auto fill(R&& range, const T& value) -> void {
+    const auto segments = range.segments();
+
+    std::fill(segments.first.begin(), segments.first.end(), value);
+    std::fill(segments.second.begin(), segments.second.end(), value);
+}
+
+}
+
+/*------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <coroutine>
+#include <expected>
+#include <optional>
+#include <stop_token>
+#include <utility>
+
+#include "ringbuf.hpp"
+#include "wait.hpp"
+
+namespace core::ringbuf {
+
+namespace async_impl {
+
+/// State shared by PushAwaitable and PopAwaitable.
+///
+/// If a stop is requested on token while the coroutine is suspended, it's removed from the queue
+/// and resumed with Error::Cancelled on the thread which requested the stop.
+template<typename Result>
+struct Operation: Awaiter {
+    Operation(WaitQueue& queue, std::stop_token token) noexcept;
+
+    Operation(const Operation& other) = delete;
+    auto operator=(const Operation& other) -> Operation& = delete;
+
+    auto await_resume() noexcept -> Result;
+
+protected:
+    template<typename F>
+    auto suspend(std::coroutine_handle<> handle, F&& attempt) noexcept -> bool;
+
+    Result _result{std::unexpected{Error::Cancelled()}};
+
+private:
+    struct Cancel {
+        Operation* operation;
+        auto operator()() const noexcept -> void;
+    };
+
+    WaitQueue* _queue;
+    std::stop_token _token;
+    std::optional<std::stop_callback<Cancel>> _on_stop{};
+};
+
+}
+
+/// Awaitable returned by async_push().
+///
+/// Completes immediately if there's space. Otherwise the coroutine is suspended until a consumer
+/// frees some, and is then resumed on that consumer's thread with the value already pushed.
+template<typename Buffer, typename T>
+struct PushAwaitable: async_impl::Operation<std::expected<void, Error>> {
+    PushAwaitable(Buffer& buffer, T value, std::stop_token token) noexcept;
+
+    auto await_ready() noexcept -> bool;
+    auto await_suspend(std::coroutine_handle<> handle) noexcept -> bool;
+
+private:
+    static auto retry(Awaiter& awaiter) noexcept -> bool;
+    auto attempt() noexcept -> bool;
+
+    Buffer* _buffer;
+    T _value;
+};
+
+/// Awaitable returned by async_pop().
+///
+/// Completes immediately if there's data. Otherwise the coroutine is suspended until a producer
+/// pushes some, and is then resumed on that producer's thread with the element already popped.
+template<typename Buffer, typename T>
+struct PopAwaitable: async_impl::Operation<std::expected<T, Error>> {
+    PopAwaitable(Buffer& buffer, std::stop_token token) noexcept;
+
+    auto await_ready() noexcept -> bool;
+    auto await_suspend(std::coroutine_handle<> handle) noexcept -> bool;
+
+private:
+    static auto retry(Awaiter& awaiter) noexcept -> bool;
+    auto attempt() noexcept -> bool;
+
+    Buffer* _buffer;
+};
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename Result>
+async_impl::Operation<Result>::Operation(WaitQueue& queue, std::stop_token token) noexcept
+    : _queue{&queue}, _token{std::move(token)} {}
+
+template<typename Result>
+auto async_impl::Operation<Result>::await_resume() noexcept -> Result {
+    return std::move(this->_result);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Queue the coroutine unless attempt succeeds or a stop has already been requested.
+///
+/// @return true if the coroutine was suspended.
+template<typename Result>
+template<typename F>
+auto async_impl::Operation<Result>::suspend(const std::coroutine_handle<> handle,
+                                            F&& attempt) noexcept -> bool {
+    this->handle = handle;
+
+    // If a stop is already requested this runs Cancel straight away, which does nothing since the
+    // coroutine isn't queued yet. The check under the queue's lock below catches it instead.
+    if (this->_token.stop_possible()) {
+        this->_on_stop.emplace(this->_token, Cancel{this});
+    }
+
+    return this->_queue->suspend(*this, [&] {
+        if (this->_token.stop_requested()) {
+            this->_result = std::unexpected{Error::Cancelled()};
+            return true;
+        }
+
+        return attempt();
+    });
+}
+
+template<typename Result>
+auto async_impl::Operation<Result>::Cancel::operator()() const noexcept -> void {
+    if (this->operation->_queue->remove(*this->operation)) {
+        this->operation->_result = std::unexpected{Error::Cancelled()};
+        this->operation->handle.resume();
+    }
+}
+
+////////////////////////////////////////////////////////////////
+
+template<typename Buffer, typename T>
+PushAwaitable<Buffer, T>::PushAwaitable(Buffer& buffer, T value, std::stop_token token) noexcept
+    : async_impl::Operation<std::expected<void, Error>>{buffer._producer_waiters, std::move(token)},
+      _buffer{&buffer},
+      _value{std::move(value)} {
+    this->complete = &PushAwaitable::retry;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename Buffer, typename T>
+auto PushAwaitable<Buffer, T>::await_ready() noexcept -> bool {
+    if (!this->attempt()) {
+        return false;
+    }
+
+    if (this->_result) {
+        this->_buffer->wake_consumers();
+    }
+
+    return true;
+}
+
+template<typename Buffer, typename T>
+auto PushAwaitable<Buffer, T>::await_suspend(const std::coroutine_handle<> handle) noexcept
+    -> bool {
+    if (this->suspend(handle, [this] { return this->attempt(); })) {
+        return true;
+    }
+
+    if (this->_result) {
+        this->_buffer->wake_consumers();
+    }
+
+    return false;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename Buffer, typename T>
+auto PushAwaitable<Buffer, T>::retry(Awaiter& awaiter) noexcept -> bool {
+    return static_cast<PushAwaitable&>(awaiter).attempt();
+}
+
+/// Try to push, storing the result unless the buffer was full.
+template<typename Buffer, typename T>
+auto PushAwaitable<Buffer, T>::attempt() noexcept -> bool {
+    auto result = this->_buffer->attempt_push(this->_value);
+
+    if (!result && result.error() == Error::Full()) {
+        return false;
+    }
+
+    this->_result = std::move(result);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////
+
+template<typename Buffer, typename T>
+PopAwaitable<Buffer, T>::PopAwaitable(Buffer& buffer, std::stop_token token) noexcept
+    : async_impl::Operation<std::expected<T, Error>>{buffer._consumer_waiters, std::move(token)},
+      _buffer{&buffer} {
+    this->complete = &PopAwaitable::retry;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename Buffer, typename T>
+auto PopAwaitable<Buffer, T>::await_ready() noexcept -> bool {
+    if (!this->attempt()) {
+        return false;
+    }
+
+    if (this->_result) {
+        this->_buffer->wake_producers();
+    }
+
+    return true;
+}
+
+template<typename Buffer, typename T>
+auto PopAwaitable<Buffer, T>::await_suspend(const std::coroutine_handle<> handle) noexcept
+    -> bool {
+    if (this->suspend(handle, [this] { return this->attempt(); })) {
+        return true;
+    }
+
+    if (this->_result) {
+        this->_buffer->wake_producers();
+    }
+
+    return false;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename Buffer, typename T>
+auto PopAwaitable<Buffer, T>::retry(Awaiter& awaiter) noexcept -> bool {
+    return static_cast<PopAwaitable&>(awaiter).attempt();
+}
+
+/// Try to pop, storing the result unless the buffer was empty.
+template<typename Buffer, typename T>
+auto PopAwaitable<Buffer, T>::attempt() noexcept -> bool {
+    auto result = this->_buffer->attempt_pop();
+
+    if (!result && result.error() == Error::Empty()) {
+        return false;
+    }
+
+    this->_result = std::move(result);
+    return true;
+}
+
+}
+
+/*------------------------------------------------------------------------------------------------*/
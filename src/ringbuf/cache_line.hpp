@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace core::ringbuf {
+
+/// Alignment used to keep state owned by different threads on separate cache lines.
+///
+/// Can be pinned with `CORE_RINGBUF_CACHE_LINE_SIZE` so that the layout of the concurrent buffers
+/// doesn't depend on the tuning flags of each translation unit.
+#if defined(CORE_RINGBUF_CACHE_LINE_SIZE)
+inline constexpr auto CACHE_LINE_SIZE = size_t{CORE_RINGBUF_CACHE_LINE_SIZE};
+#elif defined(__cpp_lib_hardware_interference_size)
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Winterference-size"
+    #endif
+inline constexpr auto CACHE_LINE_SIZE = size_t{std::hardware_destructive_interference_size};
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic pop
+    #endif
+#else
+inline constexpr auto CACHE_LINE_SIZE = size_t{64};
+#endif
+
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+namespace core::ringbuf {
+
+/// Size in bytes from which bulk copies use non-temporal stores, where the target has them.
+///
+/// Transfers this large would otherwise evict most of the caches just to hold data which the
+/// consumer won't read until much later. Can be tuned with `CORE_RINGBUF_NON_TEMPORAL_THRESHOLD`.
+#if defined(CORE_RINGBUF_NON_TEMPORAL_THRESHOLD)
+inline constexpr auto NON_TEMPORAL_THRESHOLD = size_t{CORE_RINGBUF_NON_TEMPORAL_THRESHOLD};
+#else
+inline constexpr auto NON_TEMPORAL_THRESHOLD = size_t{256 * 1024};
+#endif
+
+namespace copy_impl {
+
+#if defined(__AVX2__)
+using Vector = __m256i;
+
+inline auto stream(std::byte* const dst, const std::byte* const src) noexcept -> void {
+    _mm256_stream_si256(reinterpret_cast<Vector*>(dst),
+                        _mm256_loadu_si256(reinterpret_cast<const Vector*>(src)));
+}
+#elif defined(__SSE2__)
+using Vector = __m128i;
+
+inline auto stream(std::byte* const dst, const std::byte* const src) noexcept -> void {
+    _mm_stream_si128(reinterpret_cast<Vector*>(dst),
+                     _mm_loadu_si128(reinterpret_cast<const Vector*>(src)));
+}
+#endif
+
+/// Copy size bytes using non-temporal stores, falling back to memcpy on targets without them.
+inline auto stream_bytes(std::byte* dst, const std::byte* src, size_t size) noexcept -> void {
+#if defined(__AVX2__) || defined(__SSE2__)
+    constexpr auto WIDTH = sizeof(Vector);
+
+    // Streaming stores need an aligned destination so the head is copied normally. It may be the
+    // whole copy if NON_TEMPORAL_THRESHOLD has been tuned below the vector width.
+    const auto misalignment = reinterpret_cast<uintptr_t>(dst) % WIDTH;
+    const auto head = std::min(misalignment == 0 ? 0 : WIDTH - misalignment, size);
+
+    std::memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    size -= head;
+
+    for (; size >= 4 * WIDTH; size -= 4 * WIDTH) {
+        stream(dst, src);
+        stream(dst + WIDTH, src + WIDTH);
+        stream(dst + (2 * WIDTH), src + (2 * WIDTH));
+        stream(dst + (3 * WIDTH), src + (3 * WIDTH));
+
+        dst += 4 * WIDTH;
+        src += 4 * WIDTH;
+    }
+
+    for (; size >= WIDTH; size -= WIDTH) {
+        stream(dst, src);
+
+        dst += WIDTH;
+        src += WIDTH;
+    }
+
+    // Make the streamed data visible before the indices that publish it.
+    _mm_sfence();
+
+    std::memcpy(dst, src, size);
+#else
+    std::memcpy(dst, src, size);
+#endif
+}
+
+/// Copy size bytes between non-overlapping buffers.
+inline auto copy_bytes(void* const dst, const void* const src, const size_t size) noexcept -> void {
+    if (size >= NON_TEMPORAL_THRESHOLD) {
+        stream_bytes(static_cast<std::byte*>(dst), static_cast<const std::byte*>(src), size);
+    } else if (size > 0) {
+        std::memcpy(dst, src, size);
+    }
+}
+
+}
+
+/// @brief Copy source to destination, which must not overlap and must hold live elements.
+///
+/// Trivially copyable types are copied as raw bytes and large transfers bypass the cache.
+/// Anything else, or anything during constant evaluation, is copy assigned one element at a time.
+template<typename T>
+constexpr auto copy_elements(const std::type_identity_t<std::span<const T>> source,
+                             T* const destination) noexcept(std::is_nothrow_copy_assignable_v<T>)
+    -> void {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if !consteval {
+            copy_impl::copy_bytes(destination, source.data(), source.size_bytes());
+            return;
+        }
+    }
+
+    std::copy(source.begin(), source.end(), destination);
+}
+
+}
+
+/*------------------------------------------------------------------------------------------------*/
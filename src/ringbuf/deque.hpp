@@ -0,0 +1,294 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "cache_line.hpp"
+#include "ringbuf.hpp"
+#include "storage.hpp"
+
+namespace core::ringbuf {
+
+/// Element types which a thief can read while the owner may be overwriting the slot.
+///
+/// Slots are read and written through std::atomic_ref, so they have to fit in a lock-free atomic.
+/// In practice these are pointers or small handles to the actual work.
+template<typename T>
+concept StealableElement = TrivialElement<T> && std::atomic_ref<T>::is_always_lock_free
+                           && alignof(T) >= std::atomic_ref<T>::required_alignment;
+
+/// Chase-Lev work-stealing deque.
+///
+/// One owner thread pushes and pops at the bottom, like a stack, while any number of thieves steal
+/// from the top. This follows the C11 formulation by Lê, Pop, Cohen and Zappa Nardelli. The owner
+/// only publishes the bottom index with plain stores and fences, so push() never uses an atomic
+/// read-modify-write and pop() only uses one to race thieves for the last element. Thieves claim
+/// the top element with a CAS, and a steal() which loses that race fails with Error::Contended
+/// rather than retrying, so the caller can try another victim.
+///
+/// When push() finds the deque full it grows it to twice the size, allocating the new array from
+/// the deque's std::pmr::memory_resource. Outgrown arrays are kept until the deque is destroyed as
+/// a thief may still be reading from one, but since the size doubles they never add up to more
+/// than the current array.
+///
+/// The top and bottom indices live on separate cache lines. Moving a deque isn't thread safe, so
+/// it must be done before it's shared. size() and empty() are only a snapshot while other threads
+/// are active.
+template<StealableElement T>
+struct WorkStealingDeque {
+    static auto create(size_t capacity,
+                       std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        noexcept -> std::expected<WorkStealingDeque, Error>;
+
+    WorkStealingDeque(const WorkStealingDeque& other) = delete;
+    WorkStealingDeque(WorkStealingDeque&& other) noexcept;
+    ~WorkStealingDeque() noexcept = default;
+
+    auto operator=(const WorkStealingDeque& other) -> WorkStealingDeque& = delete;
+    auto operator=(WorkStealingDeque&& other) noexcept -> WorkStealingDeque&;
+
+    auto push(T value) noexcept -> std::expected<void, Error>;
+    auto pop() noexcept -> std::expected<T, Error>;
+
+    auto steal() noexcept -> std::expected<T, Error>;
+
+    auto empty() const noexcept -> bool;
+    auto size() const noexcept -> size_t;
+    auto capacity() const noexcept -> size_t;
+
+private:
+    using Array = Storage<T, std::dynamic_extent>;
+
+    explicit WorkStealingDeque(std::unique_ptr<Array> array);
+
+    static auto load(Array& array, int64_t index) noexcept -> T;
+    static auto store(Array& array, int64_t index, T value) noexcept -> void;
+
+    auto grow(int64_t top, int64_t bottom) noexcept -> std::expected<void, Error>;
+
+    /// Next element to steal, only advanced by CAS.
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> _top{};
+
+    /// One past the owner's most recent element, only written by the owner.
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> _bottom{};
+    std::atomic<Array*> _array{};
+
+    /// Every array the deque has used, the current one last. Only touched by the owner.
+    std::vector<std::unique_ptr<Array>> _arrays{};
+};
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+template<StealableElement T>
+WorkStealingDeque<T>::WorkStealingDeque(std::unique_ptr<Array> array) :
+    _array{array.get()} {
+    this->_arrays.push_back(std::move(array));
+}
+
+template<StealableElement T>
+WorkStealingDeque<T>::WorkStealingDeque(WorkStealingDeque&& other) noexcept :
+    _top{other._top.load(std::memory_order_relaxed)},
+    _bottom{other._bottom.load(std::memory_order_relaxed)},
+    _array{other._array.exchange(nullptr, std::memory_order_relaxed)},
+    _arrays{std::move(other._arrays)} {
+    other._top.store(0, std::memory_order_relaxed);
+    other._bottom.store(0, std::memory_order_relaxed);
+}
+
+template<StealableElement T>
+auto WorkStealingDeque<T>::operator=(WorkStealingDeque&& other) noexcept -> WorkStealingDeque& {
+    const auto swap = [](auto& lhs, auto& rhs) {
+        lhs.store(rhs.exchange(lhs.load(std::memory_order_relaxed), std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+    };
+
+    swap(this->_top, other._top);
+    swap(this->_bottom, other._bottom);
+    swap(this->_array, other._array);
+    std::swap(this->_arrays, other._arrays);
+
+    return *this;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Create a deque with space for capacity elements before it first has to grow.
+///
+/// @param capacity Initial number of elements, rounded up to a power of two.
+/// @param resource Memory resource the elements are allocated from, now and when growing.
+///
+/// @return The deque or Error::Alloc if the storage couldn't be allocated.
+template<StealableElement T>
+auto WorkStealingDeque<T>::create(const size_t capacity,
+                                  std::pmr::memory_resource* const resource) noexcept
+    -> std::expected<WorkStealingDeque, Error> {
+    try {
+        const auto size = std::bit_ceil(std::max(capacity, size_t{2}));
+        return WorkStealingDeque(std::make_unique<Array>(size, resource));
+    } catch (...) {
+        return std::unexpected{Error::Alloc()};
+    }
+}
+
+////////////////////////////////////////////////////////////////
+
+template<StealableElement T>
+auto WorkStealingDeque<T>::load(Array& array, const int64_t index) noexcept -> T {
+    const auto slot = static_cast<size_t>(index) & (array.size() - 1);
+    return std::atomic_ref<T>{array[slot]}.load(std::memory_order_relaxed);
+}
+
+template<StealableElement T>
+auto WorkStealingDeque<T>::store(Array& array, const int64_t index, const T value) noexcept
+    -> void {
+    const auto slot = static_cast<size_t>(index) & (array.size() - 1);
+    std::atomic_ref<T>{array[slot]}.store(value, std::memory_order_relaxed);
+}
+
+/// Copy the live elements into an array twice the size and publish it to thieves.
+template<StealableElement T>
+auto WorkStealingDeque<T>::grow(const int64_t top, const int64_t bottom) noexcept
+    -> std::expected<void, Error> {
+    auto& current = *this->_arrays.back();
+
+    try {
+        // Reserve first so that nothing can fail once the new array is published.
+        this->_arrays.reserve(this->_arrays.size() + 1);
+        auto array = std::make_unique<Array>(current.size() * 2, current.resource());
+
+        for (auto i = top; i < bottom; i++) {
+            store(*array, i, load(current, i));
+        }
+
+        this->_array.store(array.get(), std::memory_order_release);
+        this->_arrays.push_back(std::move(array));
+    } catch (...) {
+        return std::unexpected{Error::Alloc()};
+    }
+
+    return {};
+}
+
+////////////////////////////////////////////////////////////////
+
+/// @brief Push value onto the bottom of the deque, growing it if it's full. Owner only.
+///
+/// @return Error::Alloc if the deque was full and couldn't grow.
+template<StealableElement T>
+auto WorkStealingDeque<T>::push(const T value) noexcept -> std::expected<void, Error> {
+    const auto bottom = this->_bottom.load(std::memory_order_relaxed);
+    const auto top = this->_top.load(std::memory_order_acquire);
+
+    if (bottom - top >= static_cast<int64_t>(this->_arrays.back()->size())) {
+        if (auto result = this->grow(top, bottom); !result) {
+            return result;
+        }
+    }
+
+    store(*this->_arrays.back(), bottom, value);
+
+    // Thieves which see the new bottom must also see the element.
+    this->_bottom.store(bottom + 1, std::memory_order_release);
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Pop the most recently pushed element from the bottom of the deque. Owner only.
+///
+/// @return Error::Empty if there's nothing left, including when a thief took the last element.
+template<StealableElement T>
+auto WorkStealingDeque<T>::pop() noexcept -> std::expected<T, Error> {
+    const auto bottom = this->_bottom.load(std::memory_order_relaxed) - 1;
+    this->_bottom.store(bottom, std::memory_order_relaxed);
+
+    // Thieves either see the lowered bottom, or this sees the top they advanced.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = this->_top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        this->_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return std::unexpected{Error::Empty()};
+    }
+
+    const auto value = load(*this->_arrays.back(), bottom);
+
+    if (top == bottom) {
+        // The last element, which a thief may be trying to take too.
+        const auto won = this->_top.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+
+        this->_bottom.store(bottom + 1, std::memory_order_relaxed);
+
+        if (!won) {
+            return std::unexpected{Error::Empty()};
+        }
+    }
+
+    return value;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Steal the oldest element from the top of the deque. Any thread.
+///
+/// @return Error::Empty if there's nothing to steal, or Error::Contended if another thread took
+///         the element first.
+template<StealableElement T>
+auto WorkStealingDeque<T>::steal() noexcept -> std::expected<T, Error> {
+    auto top = this->_top.load(std::memory_order_acquire);
+
+    // Pairs with the fence in pop().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto bottom = this->_bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom) {
+        return std::unexpected{Error::Empty()};
+    }
+
+    const auto value = load(*this->_array.load(std::memory_order_acquire), top);
+
+    if (!this->_top.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return std::unexpected{Error::Contended()};
+    }
+
+    return value;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<StealableElement T>
+auto WorkStealingDeque<T>::empty() const noexcept -> bool {
+    return this->size() == 0;
+}
+
+template<StealableElement T>
+auto WorkStealingDeque<T>::size() const noexcept -> size_t {
+    const auto top = this->_top.load(std::memory_order_acquire);
+    const auto bottom = this->_bottom.load(std::memory_order_acquire);
+
+    return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+}
+
+/// @brief Get the number of elements the deque can hold before it next grows, or 0 if it's been
+///        moved from.
+template<StealableElement T>
+auto WorkStealingDeque<T>::capacity() const noexcept -> size_t {
+    const auto* const array = this->_array.load(std::memory_order_acquire);
+    return array != nullptr ? array->size() : 0;
+}
+
+}
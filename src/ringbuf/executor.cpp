@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <optional>
+
+#include "executor.hpp"
+
+namespace {
+
+/// The pool and index of the worker running on this thread, if any.
+thread_local const core::ringbuf::ThreadPool* current_pool{};
+thread_local size_t current_worker{};
+
+/// Initial size of each worker's deque, which grows as needed.
+constexpr auto DEQUE_CAPACITY = size_t{256};
+
+}
+
+/// Falls back to a single worker if the number of hardware threads isn't known.
+auto core::ringbuf::ThreadPool::create(const size_t workers) noexcept
+    -> std::expected<std::unique_ptr<ThreadPool>, Error> {
+    auto pool = std::unique_ptr<ThreadPool>{};
+    const auto count = std::max(workers, size_t{1});
+
+    try {
+        pool.reset(new ThreadPool());
+        pool->_deques.reserve(count);
+        pool->_threads.reserve(count);
+
+        for (auto i = size_t{0}; i < count; i++) {
+            auto deque = WorkStealingDeque<Task*>::create(DEQUE_CAPACITY);
+            if (!deque) {
+                return std::unexpected{deque.error()};
+            }
+
+            pool->_deques.push_back(std::move(*deque));
+        }
+
+        // Every deque must exist before any worker starts stealing from them.
+        for (auto i = size_t{0}; i < count; i++) {
+            pool->_threads.emplace_back([self = pool.get(), i] { self->run(i); });
+        }
+    } catch (...) {
+        // Destroying the pool joins any workers which did start.
+        return std::unexpected{Error::Alloc()};
+    }
+
+    return pool;
+}
+
+core::ringbuf::ThreadPool::~ThreadPool() noexcept {
+    this->stop();
+
+    // Anything submitted from outside while the workers were finishing.
+    while (const auto task = this->_queue.try_pop()) {
+        (*task)->run(*task);
+    }
+}
+
+/// Stop accepting tasks, then join the workers once they've run out of them.
+auto core::ringbuf::ThreadPool::stop() noexcept -> void {
+    this->_stopping.store(true, std::memory_order_release);
+    this->_idle.notify();
+
+    for (auto& thread : this->_threads) {
+        thread.join();
+    }
+
+    this->_threads.clear();
+}
+
+auto core::ringbuf::ThreadPool::workers() const noexcept -> size_t {
+    return this->_deques.size();
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// Tasks from a worker are still accepted while stopping, since it'll run them before it exits.
+auto core::ringbuf::ThreadPool::schedule(Task* const task) noexcept -> std::expected<void, Error> {
+    auto result = std::expected<void, Error>{};
+
+    if (current_pool == this) {
+        result = this->_deques[current_worker].push(task);
+    } else if (this->_stopping.load(std::memory_order_acquire)) {
+        return std::unexpected{Error::Closed()};
+    } else {
+        result = this->_queue.try_push(task);
+    }
+
+    // One task can only keep one worker busy.
+    if (result) {
+        this->_idle.notify_one();
+    }
+
+    return result;
+}
+
+/// Find a task for worker, from its own deque first, then the shared queue, then other workers.
+auto core::ringbuf::ThreadPool::find(const size_t worker) noexcept -> Task* {
+    if (const auto task = this->_deques[worker].pop()) {
+        return *task;
+    }
+
+    if (const auto task = this->_queue.try_pop()) {
+        return *task;
+    }
+
+    // Start with the next worker along so that thieves spread out over their victims. A steal
+    // which lost a race may have left tasks behind, so keep going round until every victim has
+    // been seen empty, rather than parking while there's work.
+    const auto count = this->_deques.size();
+    auto contended = true;
+
+    while (contended) {
+        contended = false;
+
+        for (auto i = size_t{1}; i < count; i++) {
+            const auto task = this->_deques[(worker + i) % count].steal();
+            if (task) {
+                return *task;
+            }
+
+            contended = contended || task.error() == Error::Contended();
+        }
+    }
+
+    return nullptr;
+}
+
+auto core::ringbuf::ThreadPool::run(const size_t worker) noexcept -> void {
+    current_pool = this;
+    current_worker = worker;
+
+    while (true) {
+        auto* task = static_cast<Task*>(nullptr);
+
+        this->_idle.wait_until(
+            [&] {
+                task = this->find(worker);
+                return task != nullptr || this->_stopping.load(std::memory_order_acquire);
+            },
+            std::nullopt);
+
+        // Only give up once stopping and there's nothing left to find.
+        if (task == nullptr) {
+            break;
+        }
+
+        task->run(task);
+    }
+
+    current_pool = nullptr;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "deque.hpp"
+#include "mpmc.hpp"
+#include "ringbuf.hpp"
+#include "wait.hpp"
+
+namespace core::ringbuf {
+
+namespace executor_impl {
+
+/// Type erased task, small enough to be passed around the deques by pointer.
+struct Task {
+    /// Run the task and free it.
+    using Run = auto (*)(Task* task) noexcept -> void;
+
+    Run run{};
+};
+
+template<typename F>
+struct Job: Task {
+    template<typename U>
+    explicit Job(U&& f) : Task{&Job::invoke}, function{std::forward<U>(f)} {}
+
+    static auto invoke(Task* const task) noexcept -> void {
+        auto* const job = static_cast<Job*>(task);
+        std::invoke(job->function);
+        delete job;
+    }
+
+    F function;
+};
+
+}
+
+/// Minimal thread pool with a work-stealing deque per worker.
+///
+/// Tasks submitted from a worker are pushed onto that worker's own WorkStealingDeque, and it runs
+/// them newest first while they're still in its cache. Tasks submitted from any other thread go
+/// through a lock-free MpmcRingBuffer. An idle worker checks its own deque, then the shared queue,
+/// then steals the oldest task from each of the other workers in turn, so there's no central lock
+/// for parallel work to contend on. Workers with nothing to do spin briefly and then park on a
+/// WaitQueue. submit() only makes a syscall when someone is actually parked, and then wakes a
+/// single worker for its single task.
+///
+/// Destroying the pool runs every task already submitted before it joins the workers, including
+/// any which those tasks submit in turn. Once destruction has started, submit() from outside the
+/// pool fails with Error::Closed. A task which throws terminates the program.
+struct ThreadPool {
+    /// Number of tasks from outside the pool which can be waiting before submit() fails.
+    static constexpr auto QUEUE_CAPACITY = size_t{1024};
+
+    static auto create(size_t workers = std::thread::hardware_concurrency()) noexcept
+        -> std::expected<std::unique_ptr<ThreadPool>, Error>;
+
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool(ThreadPool&& other) = delete;
+    ~ThreadPool() noexcept;
+
+    auto operator=(const ThreadPool& other) -> ThreadPool& = delete;
+    auto operator=(ThreadPool&& other) -> ThreadPool& = delete;
+
+    template<typename F>
+        requires std::invocable<std::decay_t<F>&>
+    auto submit(F&& function) noexcept -> std::expected<void, Error>;
+
+    auto workers() const noexcept -> size_t;
+
+private:
+    using Task = executor_impl::Task;
+
+    ThreadPool() noexcept = default;
+
+    auto schedule(Task* task) noexcept -> std::expected<void, Error>;
+    auto find(size_t worker) noexcept -> Task*;
+    auto run(size_t worker) noexcept -> void;
+    auto stop() noexcept -> void;
+
+    std::vector<WorkStealingDeque<Task*>> _deques{};
+    MpmcRingBuffer<Task*, QUEUE_CAPACITY> _queue{};
+
+    /// Workers waiting for a task.
+    alignas(CACHE_LINE_SIZE) WaitQueue _idle{};
+    std::atomic<bool> _stopping{};
+
+    std::vector<std::thread> _threads{};
+};
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Run function on one of the workers.
+///
+/// @return Error::Closed if the pool is being destroyed, Error::Full if too many tasks from outside
+///         the pool are already waiting, or Error::Alloc if the task or a worker's deque couldn't
+///         be allocated.
+template<typename F>
+    requires std::invocable<std::decay_t<F>&>
+auto ThreadPool::submit(F&& function) noexcept -> std::expected<void, Error> {
+    using Job = executor_impl::Job<std::decay_t<F>>;
+
+    auto* job = static_cast<Job*>(nullptr);
+
+    try {
+        job = new Job(std::forward<F>(function));
+    } catch (...) {
+        return std::unexpected{Error::Alloc()};
+    }
+
+    auto result = this->schedule(job);
+    if (!result) {
+        delete job;
+    }
+
+    return result;
+}
+
+}
@@ -0,0 +1,77 @@
+#if defined(__unix__)
+    #include <sys/uio.h>
+#endif
+
+#include <cerrno>
+
+#include "io.hpp"
+
+auto core::ringbuf::io_impl::read_segments(const int fd,
+                                           const std::span<std::byte> first,
+                                           const std::span<std::byte> second) noexcept
+    -> std::expected<size_t, Error> {
+#if defined(__unix__)
+    const iovec regions[] = {{first.data(), first.size()}, {second.data(), second.size()}};
+    const auto count = second.empty() ? 1 : 2;
+
+    while (true) {
+        const auto read = readv(fd, regions, count);
+
+        if (read > 0) {
+            return static_cast<size_t>(read);
+        }
+
+        if (read == 0) {
+            return std::unexpected{Error::Closed()};
+        }
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+
+        if (errno != EINTR) {
+            return std::unexpected{Error::Io()};
+        }
+    }
+#else
+    static_cast<void>(fd);
+    static_cast<void>(first);
+    static_cast<void>(second);
+    return std::unexpected{Error::Io()};
+#endif
+}
+
+auto core::ringbuf::io_impl::write_segments(const int fd,
+                                            const std::span<const std::byte> first,
+                                            const std::span<const std::byte> second) noexcept
+    -> std::expected<size_t, Error> {
+#if defined(__unix__)
+    // writev() doesn't write through iov_base, it's only non-const to share iovec with readv().
+    const iovec regions[] = {
+        {const_cast<std::byte*>(first.data()), first.size()},
+        {const_cast<std::byte*>(second.data()), second.size()},
+    };
+    const auto count = second.empty() ? 1 : 2;
+
+    while (true) {
+        const auto written = writev(fd, regions, count);
+
+        if (written >= 0) {
+            return static_cast<size_t>(written);
+        }
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+
+        if (errno != EINTR) {
+            return std::unexpected{Error::Io()};
+        }
+    }
+#else
+    static_cast<void>(fd);
+    static_cast<void>(first);
+    static_cast<void>(second);
+    return std::unexpected{Error::Io()};
+#endif
+}
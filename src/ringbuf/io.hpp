@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+#include "ringbuf.hpp"
+#include "segments.hpp"
+
+namespace core::ringbuf::io_impl {
+
+/// Read from fd into first then second with a single readv().
+auto read_segments(int fd, std::span<std::byte> first, std::span<std::byte> second) noexcept
+    -> std::expected<size_t, Error>;
+
+/// Write first then second to fd with a single writev().
+auto write_segments(int fd, std::span<const std::byte> first, std::span<const std::byte> second)
+    noexcept -> std::expected<size_t, Error>;
+
+template<typename T>
+auto segments_of(const Segments<T> segments) noexcept -> Segments<T> {
+    return segments;
+}
+
+/// MirroredRingBuffer regions are already contiguous.
+template<typename T>
+auto segments_of(const std::span<T> span) noexcept -> Segments<T> {
+    return Segments<T>{span, {}};
+}
+
+}
+
+namespace core::ringbuf {
+
+/// Buffers of bytes which can be written and read in place, such as RingBuffer<uint8_t, N> or
+/// MirroredRingBuffer<std::byte>.
+template<typename Buffer>
+concept ByteBuffer = sizeof(std::ranges::range_value_t<Buffer>) == 1 &&
+                     std::is_trivially_copyable_v<std::ranges::range_value_t<Buffer>> &&
+                     requires(Buffer& buf, size_t count) {
+                         buf.prepare_write(count);
+                         buf.commit_write(count);
+                         buf.peek_read();
+                         buf.consume(count);
+                     };
+
+/// @brief Read as much from fd as fits into buffer's free space.
+///
+/// The free space is passed as a single readv() of up to two regions, so data which wraps around
+/// the end of the storage costs no extra copy or system call. Interrupted reads are retried.
+///
+/// @return The number of bytes read, which is 0 if fd is non-blocking and has no data. Fails with
+///         Error::Full if buffer has no free space, Error::Closed at end of file, or Error::Io if
+///         readv() failed, in which case errno is left set.
+template<ByteBuffer Buffer>
+auto read_from(Buffer& buffer, const int fd) noexcept -> std::expected<size_t, Error> {
+    const auto free = buffer.prepare_write(buffer.free());
+    if (!free) {
+        return std::unexpected{free.error()};
+    }
+
+    const auto segments = io_impl::segments_of(*free);
+    if (segments.empty()) {
+        return std::unexpected{Error::Full()};
+    }
+
+    const auto read = io_impl::read_segments(
+        fd, std::as_writable_bytes(segments.first), std::as_writable_bytes(segments.second));
+
+    if (read && *read > 0) {
+        static_cast<void>(buffer.commit_write(*read));
+    }
+
+    return read;
+}
+
+/// @brief Write as much of buffer to fd as it accepts, and remove what was written.
+///
+/// The contents are passed as a single writev() of up to two regions. Interrupted writes are
+/// retried.
+///
+/// @return The number of bytes written, which is 0 if fd is non-blocking and can't accept any.
+///         Fails with Error::Empty if buffer is empty, or Error::Io if writev() failed, in which
+///         case errno is left set.
+template<ByteBuffer Buffer>
+auto write_to(Buffer& buffer, const int fd) noexcept -> std::expected<size_t, Error> {
+    const auto segments = io_impl::segments_of(buffer.peek_read());
+    if (segments.empty()) {
+        return std::unexpected{Error::Empty()};
+    }
+
+    const auto written =
+        io_impl::write_segments(fd, std::as_bytes(segments.first), std::as_bytes(segments.second));
+
+    if (written && *written > 0) {
+        static_cast<void>(buffer.consume(*written));
+    }
+
+    return written;
+}
+
+}
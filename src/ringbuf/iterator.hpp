@@ -1,5 +1,6 @@
 #pragma once
 
+#include <bit>
 #include <cstddef>
 #include <format>
 #include <span>
@@ -62,13 +63,15 @@ struct Iterator {
     constexpr Iterator(std::span<T> data, size_t ptr, size_t cycle) noexcept;
 
 private:
+    constexpr auto seek(difference_type offset) noexcept -> void;
+
     std::span<T> data{};
     size_t ptr{};
     ssize_t cycle{};
 
     friend struct Sentinel;
 
-    template<typename U, size_t C>
+    template<typename U, size_t C, typename S>
     friend struct RingBuffer;
 
     friend struct std::formatter<core::ringbuf::Iterator<T>, char>;
@@ -107,7 +110,7 @@ private:
     template<typename T>
     friend struct Iterator;
 
-    template<typename T, size_t C>
+    template<typename T, size_t C, typename S>
     friend struct RingBuffer;
 
     friend struct std::formatter<core::ringbuf::Sentinel, char>;
@@ -240,84 +243,67 @@ constexpr auto Iterator<T>::operator-(const Iterator& other) const noexcept -> d
 
 template<typename T>
 constexpr auto Iterator<T>::operator+=(const difference_type other) noexcept -> Iterator& {
-    const auto old_ptr = static_cast<ssize_t>(this->ptr);
-    const auto data_size = static_cast<ssize_t>(this->data.size());
+    this->seek(other);
+    return *this;
+}
 
-    auto new_ptr = (old_ptr + other);
+template<typename T>
+constexpr auto Iterator<T>::operator-=(const difference_type other) noexcept -> Iterator& {
+    this->seek(-other);
+    return *this;
+}
 
-    // Check upper bound and wrap if required.
-    if (new_ptr >= data_size) {
-        const auto result = std::div(new_ptr, data_size);
-        this->cycle += result.quot;
-        new_ptr = result.rem;
-    }
+template<typename T>
+constexpr auto Iterator<T>::operator[](const size_t index) const noexcept -> value_type& {
+    const auto data_size = this->data.size();
 
-    // Check upper bound and wrap if required.
-    if (new_ptr < 0) {
-        const auto result = std::div(new_ptr, data_size);
-        this->cycle += result.quot;
-        new_ptr = data_size + result.rem;
+    if (std::has_single_bit(data_size)) {
+        return this->data[(this->ptr + index) & (data_size - 1)];
     }
 
-    this->ptr = static_cast<size_t>(new_ptr);
-    return *this;
+    return this->data[(this->ptr + index) % data_size];
 }
 
+/// Move the iterator by offset, wrapping ptr back into the data and adjusting cycle to match.
 template<typename T>
-constexpr auto Iterator<T>::operator-=(const difference_type other) noexcept -> Iterator& {
-    const auto old_ptr = static_cast<ssize_t>(this->ptr);
+constexpr auto Iterator<T>::seek(const difference_type offset) noexcept -> void {
     const auto data_size = static_cast<ssize_t>(this->data.size());
+    const auto new_ptr = static_cast<ssize_t>(this->ptr) + offset;
 
-    auto new_ptr = old_ptr - other;
-
-    // Check upper bound and wrap if required.
-    if (new_ptr >= data_size) {
-        const auto result = std::div(new_ptr, data_size);
-        this->cycle += result.quot;
-        new_ptr = result.rem;
+    // Staying within the current cycle is the common case.
+    if (new_ptr >= 0 && new_ptr < data_size) {
+        this->ptr = static_cast<size_t>(new_ptr);
+        return;
     }
 
-    // Check upper bound and wrap if required.
-    if (new_ptr < 0) {
-        const auto result = std::div(new_ptr, data_size);
-        this->cycle += result.quot;
-        new_ptr = data_size + result.rem;
+    // Power of two sizes wrap with a shift and a mask. The iterator only holds a dynamic span,
+    // so this is a runtime check even when the buffer's capacity is a compile-time constant, but
+    // it goes the same way for every seek on a given buffer and so is well predicted.
+    if (std::has_single_bit(this->data.size())) {
+        this->cycle += new_ptr >> std::countr_zero(this->data.size());
+        this->ptr = static_cast<size_t>(new_ptr & (data_size - 1));
+        return;
     }
 
-    this->ptr = static_cast<size_t>(new_ptr);
-    return *this;
-}
+    // Otherwise use floored division so negative positions wrap correctly.
+    auto quot = new_ptr / data_size;
+    auto rem = new_ptr % data_size;
 
-template<typename T>
-constexpr auto Iterator<T>::operator[](const size_t index) const noexcept -> value_type& {
-    const auto index_adj = (this->ptr + index) % this->data.size();
-    return this->data[index_adj];
+    if (rem < 0) {
+        quot -= 1;
+        rem += data_size;
+    }
+
+    this->cycle += quot;
+    this->ptr = static_cast<size_t>(rem);
 }
 
 template<typename T>
 constexpr auto operator+(const Iterator<T>& lhs,
                          const typename Iterator<T>::difference_type rhs) noexcept -> Iterator<T> {
-    const auto lhs_ptr = static_cast<ssize_t>(lhs.ptr);
-    const auto data_size = static_cast<ssize_t>(lhs.data.size());
-
-    auto ptr = lhs_ptr + rhs;
-    auto cycle = lhs.cycle;
-
-    // Check upper bound and wrap if required.
-    if (ptr >= data_size) {
-        const auto result = std::div(ptr, data_size);
-        cycle += result.quot;
-        ptr = result.rem;
-    }
-
-    // Check upper bound and wrap if required.
-    if (ptr < 0) {
-        const auto result = std::div(ptr, data_size);
-        cycle += result.quot;
-        ptr = data_size + result.rem;
-    }
-
-    return Iterator<T>(lhs.data, static_cast<size_t>(ptr), static_cast<size_t>(cycle));
+    auto iter = lhs;
+    iter.seek(rhs);
+    return iter;
 }
 
 template<typename T>
@@ -329,27 +315,9 @@ constexpr auto operator+(const typename Iterator<T>::difference_type lhs,
 template<typename T>
 constexpr auto operator-(const Iterator<T>& lhs,
                          const typename Iterator<T>::difference_type rhs) noexcept -> Iterator<T> {
-    const auto lhs_ptr = static_cast<ssize_t>(lhs.ptr);
-    const auto data_size = static_cast<ssize_t>(lhs.data.size());
-
-    auto ptr = lhs_ptr - rhs;
-    auto cycle = lhs.cycle;
-
-    // Check upper bound and wrap if required.
-    if (ptr >= data_size) {
-        const auto result = std::div(ptr, data_size);
-        cycle += result.quot;
-        ptr = result.rem;
-    }
-
-    // Check upper bound and wrap if required.
-    if (ptr < 0) {
-        const auto result = std::div(ptr, data_size);
-        cycle += result.quot;
-        ptr = data_size + result.rem;
-    }
-
-    return Iterator<T>(lhs.data, static_cast<size_t>(ptr), static_cast<size_t>(cycle));
+    auto iter = lhs;
+    iter.seek(-rhs);
+    return iter;
 }
 
 template<typename T>
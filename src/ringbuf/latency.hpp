@@ -0,0 +1,174 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+
+#include "stats.hpp"
+
+namespace core::ringbuf {
+
+/// Latencies read from a LatencyHistogram.
+///
+/// Each is the upper bound of the bucket the percentile fell in, so it overestimates by at most an
+/// eighth.
+struct LatencyPercentiles {
+    std::chrono::nanoseconds p50{};
+    std::chrono::nanoseconds p99{};
+    std::chrono::nanoseconds p999{};
+};
+
+/// Log-linear histogram of latencies in nanoseconds.
+///
+/// Each power of two is split into SUB_BUCKETS linear buckets, so the relative error is bounded
+/// across the whole range without any configuration. Latencies below SUB_BUCKETS nanoseconds are
+/// counted exactly.
+///
+/// Recording is a single counter update and never blocks. Counters are shared as SHARING
+/// describes, so a histogram written by several threads uses atomic increments while one written
+/// by a single thread only needs relaxed loads and stores. Readouts may be taken from any thread
+/// unless SHARING is Sharing::None, but aren't a consistent snapshot while recording continues.
+template<Sharing SHARING>
+struct LatencyHistogram {
+    static constexpr auto SUB_BUCKET_BITS = 3;
+    static constexpr auto SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+    static constexpr auto BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    auto record(std::chrono::nanoseconds latency) noexcept -> void;
+
+    auto count() const noexcept -> uint64_t;
+    auto percentile(double fraction) const noexcept -> std::chrono::nanoseconds;
+    auto percentiles() const noexcept -> LatencyPercentiles;
+
+private:
+    static constexpr auto bucket(uint64_t nanoseconds) noexcept -> size_t;
+    static constexpr auto upper_bound(size_t bucket) noexcept -> uint64_t;
+
+    auto snapshot() const noexcept -> std::array<uint64_t, BUCKETS>;
+
+    static auto find_percentile(const std::array<uint64_t, BUCKETS>& counts,
+                                uint64_t total,
+                                double fraction) noexcept -> std::chrono::nanoseconds;
+
+    std::array<stats_impl::Counter<SHARING>, BUCKETS> _counts{};
+};
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+/// Values below SUB_BUCKETS get a bucket each. Above that the top SUB_BUCKET_BITS bits after the
+/// leading one pick the bucket within the value's power of two.
+template<Sharing SHARING>
+constexpr auto LatencyHistogram<SHARING>::bucket(const uint64_t nanoseconds) noexcept -> size_t {
+    if (nanoseconds < SUB_BUCKETS) {
+        return static_cast<size_t>(nanoseconds);
+    }
+
+    const auto shift = std::bit_width(nanoseconds) - 1 - SUB_BUCKET_BITS;
+    const auto sub_bucket = static_cast<size_t>(nanoseconds >> shift) - SUB_BUCKETS;
+
+    return (static_cast<size_t>(shift) + 1) * SUB_BUCKETS + sub_bucket;
+}
+
+/// Largest value counted in bucket.
+template<Sharing SHARING>
+constexpr auto LatencyHistogram<SHARING>::upper_bound(const size_t bucket) noexcept -> uint64_t {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+
+    const auto shift = bucket / SUB_BUCKETS - 1;
+    const auto sub_bucket = bucket % SUB_BUCKETS;
+
+    return (uint64_t{SUB_BUCKETS + sub_bucket + 1} << shift) - 1;
+}
+
+////////////////////////////////////////////////////////////////
+
+/// @brief Count one latency. Negative latencies are counted as zero.
+template<Sharing SHARING>
+auto LatencyHistogram<SHARING>::record(const std::chrono::nanoseconds latency) noexcept -> void {
+    const auto nanoseconds = latency.count() > 0 ? static_cast<uint64_t>(latency.count()) : 0;
+    stats_impl::add<SHARING>(this->_counts[bucket(nanoseconds)], 1);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<Sharing SHARING>
+auto LatencyHistogram<SHARING>::snapshot() const noexcept -> std::array<uint64_t, BUCKETS> {
+    auto counts = std::array<uint64_t, BUCKETS>{};
+
+    for (auto i = size_t{0}; i < BUCKETS; i++) {
+        counts[i] = stats_impl::load<SHARING>(this->_counts[i]);
+    }
+
+    return counts;
+}
+
+/// Smallest bucket bound which at least fraction of the total counts fall under.
+template<Sharing SHARING>
+auto LatencyHistogram<SHARING>::find_percentile(const std::array<uint64_t, BUCKETS>& counts,
+                                                const uint64_t total,
+                                                const double fraction) noexcept
+    -> std::chrono::nanoseconds {
+    if (total == 0) {
+        return {};
+    }
+
+    const auto wanted = std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(total));
+    const auto rank = std::max(uint64_t{1}, static_cast<uint64_t>(wanted));
+
+    auto seen = uint64_t{0};
+    for (auto i = size_t{0}; i < BUCKETS; i++) {
+        seen += counts[i];
+
+        if (seen >= rank) {
+            return std::chrono::nanoseconds{
+                static_cast<std::chrono::nanoseconds::rep>(upper_bound(i))};
+        }
+    }
+
+    return std::chrono::nanoseconds::max();
+}
+
+////////////////////////////////////////////////////////////////
+
+/// @brief Get the number of latencies recorded.
+template<Sharing SHARING>
+auto LatencyHistogram<SHARING>::count() const noexcept -> uint64_t {
+    const auto counts = this->snapshot();
+    return std::accumulate(counts.begin(), counts.end(), uint64_t{0});
+}
+
+/// @brief Get the latency which fraction of the recorded latencies don't exceed.
+///
+/// @return Zero if nothing has been recorded.
+template<Sharing SHARING>
+auto LatencyHistogram<SHARING>::percentile(const double fraction) const noexcept
+    -> std::chrono::nanoseconds {
+    const auto counts = this->snapshot();
+    const auto total = std::accumulate(counts.begin(), counts.end(), uint64_t{0});
+
+    return find_percentile(counts, total, fraction);
+}
+
+/// @brief Get the p50, p99 and p999 latencies from a single read of the counters.
+template<Sharing SHARING>
+auto LatencyHistogram<SHARING>::percentiles() const noexcept -> LatencyPercentiles {
+    const auto counts = this->snapshot();
+    const auto total = std::accumulate(counts.begin(), counts.end(), uint64_t{0});
+
+    return {
+        find_percentile(counts, total, 0.5),
+        find_percentile(counts, total, 0.99),
+        find_percentile(counts, total, 0.999),
+    };
+}
+
+}
@@ -0,0 +1,67 @@
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+#include "mirrored.hpp"
+
+auto core::ringbuf::mirror_impl::page_size() noexcept -> size_t {
+#if defined(__linux__)
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 4096;
+#endif
+}
+
+auto core::ringbuf::mirror_impl::map(const size_t size) noexcept
+    -> std::expected<std::byte*, Error> {
+#if defined(__linux__)
+    const auto fd = memfd_create("core-ringbuf", MFD_CLOEXEC);
+    if (fd < 0) {
+        return std::unexpected{Error::Alloc()};
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        return std::unexpected{Error::Alloc()};
+    }
+
+    // Reserve space for both copies, then map the file over each half.
+    auto* const base = mmap(nullptr, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return std::unexpected{Error::Alloc()};
+    }
+
+    auto* const lower = static_cast<std::byte*>(base);
+    auto* const upper = lower + size;
+
+    const auto flags = MAP_SHARED | MAP_FIXED;
+    const auto protection = PROT_READ | PROT_WRITE;
+
+    if (mmap(lower, size, protection, flags, fd, 0) == MAP_FAILED
+        || mmap(upper, size, protection, flags, fd, 0) == MAP_FAILED) {
+        munmap(base, 2 * size);
+        close(fd);
+        return std::unexpected{Error::Alloc()};
+    }
+
+    // The mappings keep the memory alive.
+    close(fd);
+
+    return lower;
+#else
+    static_cast<void>(size);
+    return std::unexpected{Error::Alloc()};
+#endif
+}
+
+auto core::ringbuf::mirror_impl::unmap(std::byte* const address, const size_t size) noexcept
+    -> void {
+#if defined(__linux__)
+    munmap(address, 2 * size);
+#else
+    static_cast<void>(address);
+    static_cast<void>(size);
+#endif
+}
@@ -0,0 +1,375 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <expected>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "copy.hpp"
+#include "ringbuf.hpp"
+
+namespace core::ringbuf::mirror_impl {
+
+/// Size of the pages the buffer is mapped with.
+auto page_size() noexcept -> size_t;
+
+/// Map size bytes of memory twice, back to back, so that the second copy aliases the first.
+/// size must be a multiple of page_size().
+auto map(size_t size) noexcept -> std::expected<std::byte*, Error>;
+auto unmap(std::byte* address, size_t size) noexcept -> void;
+
+}
+
+namespace core::ringbuf {
+
+/// Ring buffer whose storage is mapped twice back to back in virtual memory.
+///
+/// Element i and element i + capacity() share the same physical memory, so any run of readable or
+/// writable elements is contiguous no matter where it wraps. Ranges are plain spans, bulk
+/// transfers are a single copy_elements() call and iteration is over raw pointers.
+///
+/// Only available on Linux. The capacity is rounded up to a whole number of pages.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+struct MirroredRingBuffer {
+    static auto create(size_t min_capacity) noexcept -> std::expected<MirroredRingBuffer, Error>;
+
+    MirroredRingBuffer(const MirroredRingBuffer& other) = delete;
+    MirroredRingBuffer(MirroredRingBuffer&& other) noexcept;
+    ~MirroredRingBuffer() noexcept;
+
+    auto operator=(const MirroredRingBuffer& other) -> MirroredRingBuffer& = delete;
+    auto operator=(MirroredRingBuffer&& other) noexcept -> MirroredRingBuffer&;
+
+    auto begin() noexcept -> T*;
+    auto end() noexcept -> T*;
+
+    auto segments() noexcept -> Segments<T>;
+    auto segments() const noexcept -> Segments<const T>;
+
+    auto push(T value) noexcept -> std::expected<void, Error>;
+    auto push_buffer(std::span<const T> buffer) noexcept -> std::expected<void, Error>;
+
+    auto pop() noexcept -> std::expected<T, Error>;
+    auto pop_buffer(std::span<T> buffer) noexcept -> std::expected<void, Error>;
+
+    auto prepare_write(size_t count) noexcept -> std::expected<std::span<T>, Error>;
+    auto commit_write(size_t count) noexcept -> std::expected<void, Error>;
+
+    auto peek_read() const noexcept -> std::span<const T>;
+    auto consume(size_t count) noexcept -> std::expected<void, Error>;
+
+    auto clear() noexcept -> void;
+
+    auto empty() const noexcept -> bool;
+    auto full() const noexcept -> bool;
+
+    auto size() const noexcept -> size_t;
+    auto free() const noexcept -> size_t;
+    auto capacity() const noexcept -> size_t;
+
+private:
+    MirroredRingBuffer(T* buffer, size_t capacity) noexcept;
+
+    auto advance_read(size_t count) noexcept -> void;
+
+    T* _buffer{};
+    size_t _capacity{};
+    size_t _read_ptr{};
+    size_t _size{};
+};
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+MirroredRingBuffer<T>::MirroredRingBuffer(T* const buffer, const size_t capacity) noexcept :
+    _buffer{buffer},
+    _capacity{capacity} {}
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+MirroredRingBuffer<T>::MirroredRingBuffer(MirroredRingBuffer&& other) noexcept :
+    _buffer{std::exchange(other._buffer, nullptr)},
+    _capacity{std::exchange(other._capacity, 0)},
+    _read_ptr{std::exchange(other._read_ptr, 0)},
+    _size{std::exchange(other._size, 0)} {}
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+MirroredRingBuffer<T>::~MirroredRingBuffer() noexcept {
+    if (this->_buffer != nullptr) {
+        mirror_impl::unmap(reinterpret_cast<std::byte*>(this->_buffer),
+                           this->_capacity * sizeof(T));
+    }
+}
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::operator=(MirroredRingBuffer&& other) noexcept
+    -> MirroredRingBuffer& {
+    std::swap(this->_buffer, other._buffer);
+    std::swap(this->_capacity, other._capacity);
+    std::swap(this->_read_ptr, other._read_ptr);
+    std::swap(this->_size, other._size);
+
+    return *this;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Create a buffer able to hold at least min_capacity elements.
+///
+/// @return The buffer or Error::Alloc if the memory couldn't be mapped, or min_capacity elements
+///         mapped twice wouldn't fit in the address space.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::create(const size_t min_capacity) noexcept
+    -> std::expected<MirroredRingBuffer, Error> {
+    // The mapping must be a whole number of both pages and elements.
+    const auto granularity = std::lcm(mirror_impl::page_size(), sizeof(T));
+
+    // Largest size which can be rounded up to and still mapped twice without wrapping.
+    const auto max_size = std::numeric_limits<size_t>::max() / 2 / granularity * granularity;
+    if (min_capacity > max_size / sizeof(T)) {
+        return std::unexpected{Error::Alloc()};
+    }
+
+    const auto min_size = std::max(min_capacity * sizeof(T), size_t{1});
+    const auto size = ((min_size + granularity - 1) / granularity) * granularity;
+
+    const auto memory = mirror_impl::map(size);
+    if (!memory) {
+        return std::unexpected{memory.error()};
+    }
+
+    return MirroredRingBuffer(reinterpret_cast<T*>(*memory), size / sizeof(T));
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::advance_read(const size_t count) noexcept -> void {
+    this->_read_ptr += count;
+    this->_size -= count;
+
+    if (this->_read_ptr >= this->_capacity) {
+        this->_read_ptr -= this->_capacity;
+    }
+}
+
+////////////////////////////////////////////////////////////////
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::begin() noexcept -> T* {
+    return this->_buffer + this->_read_ptr;
+}
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::end() noexcept -> T* {
+    return this->_buffer + this->_read_ptr + this->_size;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Get the contents of the buffer as Segments, for use with the algorithms in
+/// algorithm.hpp. The contents never wrap so the second segment is always empty.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::segments() noexcept -> Segments<T> {
+    return Segments<T>{std::span{this->begin(), this->_size}, {}};
+}
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::segments() const noexcept -> Segments<const T> {
+    return Segments<const T>{this->peek_read(), {}};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::push(const T value) noexcept -> std::expected<void, Error> {
+    if (this->full()) {
+        return std::unexpected{Error::Full()};
+    }
+
+    this->_buffer[this->_read_ptr + this->_size] = value;
+    this->_size++;
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::push_buffer(const std::span<const T> buffer) noexcept
+    -> std::expected<void, Error> {
+    if (buffer.size() > this->free()) {
+        return std::unexpected{Error::Full()};
+    }
+
+    copy_elements(buffer, this->end());
+    this->_size += buffer.size();
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::pop() noexcept -> std::expected<T, Error> {
+    if (this->empty()) {
+        return std::unexpected{Error::Empty()};
+    }
+
+    const auto value = this->_buffer[this->_read_ptr];
+    this->advance_read(1);
+
+    return value;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::pop_buffer(const std::span<T> buffer) noexcept
+    -> std::expected<void, Error> {
+    if (buffer.size() > this->size()) {
+        return std::unexpected{Error::Empty()};
+    }
+
+    copy_elements(std::span<const T>{this->begin(), buffer.size()}, buffer.data());
+    this->advance_read(buffer.size());
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Get the next count free elements of the buffer for writing in place.
+///
+/// Data written to the returned span is only added to the buffer by a following call to
+/// commit_write().
+///
+/// @return A span of count free elements. Returns Error::Full if there is less space free.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::prepare_write(const size_t count) noexcept
+    -> std::expected<std::span<T>, Error> {
+    if (count > this->free()) {
+        return std::unexpected{Error::Full()};
+    }
+
+    return std::span{this->end(), count};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Add count elements, previously written via prepare_write(), to the buffer.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::commit_write(const size_t count) noexcept
+    -> std::expected<void, Error> {
+    if (count > this->free()) {
+        return std::unexpected{Error::Full()};
+    }
+
+    this->_size += count;
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Get the contents of the buffer without removing them.
+///
+/// The span remains valid until the buffer is next modified.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::peek_read() const noexcept -> std::span<const T> {
+    return std::span{this->_buffer + this->_read_ptr, this->_size};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Remove count elements from the front of the buffer without copying them out.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::consume(const size_t count) noexcept -> std::expected<void, Error> {
+    if (count > this->size()) {
+        return std::unexpected{Error::Empty()};
+    }
+
+    this->advance_read(count);
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::clear() noexcept -> void {
+    this->_read_ptr = 0;
+    this->_size = 0;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::empty() const noexcept -> bool {
+    return this->_size == 0;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::full() const noexcept -> bool {
+    return this->_size == this->_capacity;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::size() const noexcept -> size_t {
+    return this->_size;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::free() const noexcept -> size_t {
+    return this->_capacity - this->_size;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto MirroredRingBuffer<T>::capacity() const noexcept -> size_t {
+    return this->_capacity;
+}
+
+static_assert(std::ranges::contiguous_range<MirroredRingBuffer<int>>);
+static_assert(std::ranges::sized_range<MirroredRingBuffer<int>>);
+
+}
+
+/*------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,578 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "async.hpp"
+#include "cache_line.hpp"
+#include "ringbuf.hpp"
+#include "stats.hpp"
+#include "wait.hpp"
+
+namespace core::ringbuf {
+
+/// Lock-free bounded multi-producer/multi-consumer queue.
+///
+/// Any number of threads may push and pop concurrently. This follows Dmitry Vyukov's bounded MPMC
+/// queue, where each slot carries a sequence number which tells producers and consumers whether
+/// it's ready for them. An operation claims a position by advancing the shared enqueue or dequeue
+/// counter with a single CAS, then hands the slot over by publishing its sequence number with
+/// release ordering.
+///
+/// The batch functions claim a whole run of positions with one CAS, so the contended atomic is
+/// amortised across the batch. A claimed slot may still be in use by a peer which claimed it one
+/// lap earlier, in which case the batch waits for that peer to finish with it.
+///
+/// push_wait() and pop_wait() block until they succeed, spinning briefly and then parking the
+/// thread. Threads blocked on the same side are all woken when the other side makes progress.
+///
+/// async_push() and async_pop() are the coroutine equivalents. Suspended coroutines are queued in
+/// FIFO order and resumed on the thread whose push or pop let them proceed, with their operation
+/// already done. close() fails any waiting or future waits with Error::Closed, although pops still
+/// drain whatever's left first. The non-waiting functions aren't affected by close().
+///
+/// Capacity must be a power of two. size(), empty() and full() are only a snapshot while other
+/// threads are active.
+///
+/// With StatsPolicy set to Stats each side counts its transfers and failures on its own cache line,
+/// which is shared with the other threads on that side only. Only try_push(), try_push_buffer(),
+/// try_pop() and try_pop_buffer() count failures, so retries while waiting don't.
+template<typename T, size_t Capacity, typename StatsPolicy = NoStats>
+struct MpmcRingBuffer {
+    static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two");
+    static_assert(std::is_nothrow_move_assignable_v<T>);
+
+    MpmcRingBuffer() noexcept;
+
+    MpmcRingBuffer(const MpmcRingBuffer& other) = delete;
+    auto operator=(const MpmcRingBuffer& other) -> MpmcRingBuffer& = delete;
+
+    auto try_push(T value) noexcept -> std::expected<void, Error>;
+    auto try_push_buffer(std::span<const T> buffer) noexcept -> std::expected<void, Error>
+        requires std::is_nothrow_copy_assignable_v<T>;
+
+    auto try_pop() noexcept -> std::expected<T, Error>;
+    auto try_pop_buffer(std::span<T> buffer) noexcept -> std::expected<void, Error>;
+
+    auto push_wait(T value) noexcept -> std::expected<void, Error>;
+    auto push_wait_for(T value, std::chrono::nanoseconds timeout) noexcept
+        -> std::expected<void, Error>;
+
+    auto pop_wait() noexcept -> std::expected<T, Error>;
+    auto pop_wait_for(std::chrono::nanoseconds timeout) noexcept -> std::expected<T, Error>;
+
+    auto async_push(T value, std::stop_token token = {}) noexcept
+        -> PushAwaitable<MpmcRingBuffer, T>;
+    auto async_pop(std::stop_token token = {}) noexcept -> PopAwaitable<MpmcRingBuffer, T>;
+
+    auto close() noexcept -> void;
+    auto closed() const noexcept -> bool;
+
+    auto empty() const noexcept -> bool;
+    auto full() const noexcept -> bool;
+
+    auto size() const noexcept -> size_t;
+    auto free() const noexcept -> size_t;
+    auto capacity() const noexcept -> size_t;
+
+    auto stats() const noexcept -> BufferStats
+        requires StatsPolicy::template Recorder<Sharing::Multi>::ENABLED;
+
+private:
+    friend struct PushAwaitable<MpmcRingBuffer, T>;
+    friend struct PopAwaitable<MpmcRingBuffer, T>;
+
+    static constexpr auto MASK = Capacity - 1;
+
+    struct Slot {
+        std::atomic<size_t> sequence{};
+        T value{};
+    };
+
+    /// A counter shared by all producers or all consumers.
+    struct alignas(CACHE_LINE_SIZE) Cursor {
+        std::atomic<size_t> position{};
+    };
+
+    static auto distance(size_t from, size_t to) noexcept -> std::ptrdiff_t;
+    static auto wait_for(const Slot& slot, size_t sequence) noexcept -> void;
+
+    auto put(T& value) noexcept -> std::expected<void, Error>;
+    auto take() noexcept -> std::expected<T, Error>;
+
+    auto attempt_push(T& value) noexcept -> std::expected<void, Error>;
+    auto attempt_pop() noexcept -> std::expected<T, Error>;
+
+    auto wake_producers() noexcept -> void;
+    auto wake_consumers() noexcept -> void;
+
+    auto push_until(T value, Deadline deadline) noexcept -> std::expected<void, Error>;
+    auto pop_until(Deadline deadline) noexcept -> std::expected<T, Error>;
+
+    using Recorder = StatsPolicy::template Recorder<Sharing::Multi>;
+
+    Cursor _enqueue{};
+    Cursor _dequeue{};
+
+    [[no_unique_address]] Recorder _stats{};
+
+    /// Producers waiting for space and consumers waiting for data.
+    alignas(CACHE_LINE_SIZE) WaitQueue _producer_waiters{};
+    alignas(CACHE_LINE_SIZE) WaitQueue _consumer_waiters{};
+    std::atomic<bool> _closed{};
+
+    alignas(CACHE_LINE_SIZE) std::array<Slot, Capacity> _slots{};
+};
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+MpmcRingBuffer<T, Capacity, StatsPolicy>::MpmcRingBuffer() noexcept {
+    for (auto i = size_t{0}; i < Capacity; i++) {
+        this->_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+////////////////////////////////////////////////////////////////
+
+/// Signed distance from one free-running position to another.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::distance(const size_t from, const size_t to) noexcept
+    -> std::ptrdiff_t {
+    return static_cast<std::ptrdiff_t>(to - from);
+}
+
+/// Wait for a peer which claimed slot one lap earlier to finish with it.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::wait_for(const Slot& slot,
+                                                      const size_t sequence) noexcept -> void {
+    constexpr auto SPINS_BEFORE_YIELD = 64;
+
+    for (auto spins = 0; slot.sequence.load(std::memory_order_acquire) != sequence; spins++) {
+        if (spins >= SPINS_BEFORE_YIELD) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////
+
+/// Push value without notifying any waiting consumers, only moving from it on success so it can be
+/// retried.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::put(T& value) noexcept
+    -> std::expected<void, Error> {
+    auto position = this->_enqueue.position.load(std::memory_order_relaxed);
+
+    while (true) {
+        auto& slot = this->_slots[position & MASK];
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto lag = distance(position, sequence);
+
+        if (lag == 0) {
+            if (this->_enqueue.position.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed)) {
+                slot.value = std::move(value);
+                slot.sequence.store(position + 1, std::memory_order_release);
+
+                this->_stats.producer.transferred(1);
+
+                // Measuring the size means reading the consumers' counter, so only do it when
+                // it's going to be recorded.
+                if constexpr (Recorder::ENABLED) {
+                    this->_stats.producer.occupancy(this->size());
+                }
+
+                return {};
+            }
+        } else if (lag < 0) {
+            return std::unexpected{Error::Full()};
+        } else {
+            position = this->_enqueue.position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// Pop an element without notifying any waiting producers.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::take() noexcept -> std::expected<T, Error> {
+    auto position = this->_dequeue.position.load(std::memory_order_relaxed);
+
+    while (true) {
+        auto& slot = this->_slots[position & MASK];
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto lag = distance(position + 1, sequence);
+
+        if (lag == 0) {
+            if (this->_dequeue.position.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed)) {
+                auto value = std::move(slot.value);
+                slot.sequence.store(position + Capacity, std::memory_order_release);
+                this->_stats.consumer.transferred(1);
+
+                return value;
+            }
+        } else if (lag < 0) {
+            return std::unexpected{Error::Empty()};
+        } else {
+            position = this->_dequeue.position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// Push value unless the buffer is closed, without notifying any waiting consumers.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::attempt_push(T& value) noexcept
+    -> std::expected<void, Error> {
+    if (this->closed()) {
+        return std::unexpected{Error::Closed()};
+    }
+
+    return this->put(value);
+}
+
+/// Pop an element, or fail with Error::Closed if the buffer is empty and closed.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::attempt_pop() noexcept -> std::expected<T, Error> {
+    auto result = this->take();
+
+    if (!result && this->closed()) {
+        return std::unexpected{Error::Closed()};
+    }
+
+    return result;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// Wake the producers, and keep alternating between the two sides for as long as completing a
+/// suspended coroutine's operation lets the other side make progress.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::wake_producers() noexcept -> void {
+    while (this->_producer_waiters.notify() && this->_consumer_waiters.notify()) {}
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::wake_consumers() noexcept -> void {
+    while (this->_consumer_waiters.notify() && this->_producer_waiters.notify()) {}
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::push_until(T value, const Deadline deadline) noexcept
+    -> std::expected<void, Error> {
+    auto result = this->attempt_push(value);
+
+    if (!result && result.error() == Error::Full()) {
+        this->_producer_waiters.wait_until(
+            [&] {
+                result = this->attempt_push(value);
+                return result || result.error() != Error::Full();
+            },
+            deadline);
+    }
+
+    if (result) {
+        this->wake_consumers();
+    }
+
+    return result;
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::pop_until(const Deadline deadline) noexcept
+    -> std::expected<T, Error> {
+    auto result = this->attempt_pop();
+
+    if (!result && result.error() == Error::Empty()) {
+        this->_consumer_waiters.wait_until(
+            [&] {
+                result = this->attempt_pop();
+                return result || result.error() != Error::Empty();
+            },
+            deadline);
+    }
+
+    if (result) {
+        this->wake_producers();
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::try_push(T value) noexcept
+    -> std::expected<void, Error> {
+    auto result = this->put(value);
+
+    if (result) {
+        this->wake_consumers();
+    } else {
+        this->_stats.producer.failed();
+        this->_stats.producer.occupancy(Capacity);
+    }
+
+    return result;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Push every element of buffer, or none of them if there isn't space for them all.
+///
+/// The elements are kept together, in order, although consumers may start reading them before the
+/// whole batch has been written.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::try_push_buffer(
+    const std::span<const T> buffer) noexcept -> std::expected<void, Error>
+    requires std::is_nothrow_copy_assignable_v<T>
+{
+    if (buffer.size() > Capacity) {
+        this->_stats.producer.failed();
+        return std::unexpected{Error::Full()};
+    }
+
+    auto position = this->_enqueue.position.load(std::memory_order_relaxed);
+
+    do {
+        const auto read = this->_dequeue.position.load(std::memory_order_relaxed);
+        const auto used = distance(read, position);
+
+        // A negative distance means position is stale and the CAS below will refresh it.
+        if (used >= 0 && static_cast<size_t>(used) + buffer.size() > Capacity) {
+            this->_stats.producer.failed();
+            this->_stats.producer.occupancy(static_cast<size_t>(used));
+            return std::unexpected{Error::Full()};
+        }
+    } while (!this->_enqueue.position.compare_exchange_weak(
+        position, position + buffer.size(), std::memory_order_relaxed));
+
+    for (auto i = size_t{0}; i < buffer.size(); i++) {
+        auto& slot = this->_slots[(position + i) & MASK];
+
+        wait_for(slot, position + i);
+        slot.value = buffer[i];
+        slot.sequence.store(position + i + 1, std::memory_order_release);
+    }
+
+    this->_stats.producer.transferred_bulk(buffer.size());
+    this->wake_consumers();
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::try_pop() noexcept -> std::expected<T, Error> {
+    auto result = this->take();
+
+    if (result) {
+        this->wake_producers();
+    } else {
+        this->_stats.consumer.failed();
+    }
+
+    return result;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Fill buffer with the oldest elements, or take none of them if there aren't enough.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::try_pop_buffer(const std::span<T> buffer) noexcept
+    -> std::expected<void, Error> {
+    auto position = this->_dequeue.position.load(std::memory_order_relaxed);
+
+    while (true) {
+        const auto write = this->_enqueue.position.load(std::memory_order_relaxed);
+        const auto available = distance(position, write);
+
+        // A negative distance means write is stale, not position, so the CAS could still succeed
+        // and claim slots which haven't been produced. Load both again instead.
+        if (available < 0) {
+            position = this->_dequeue.position.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (static_cast<size_t>(available) < buffer.size()) {
+            this->_stats.consumer.failed();
+            return std::unexpected{Error::Empty()};
+        }
+
+        if (this->_dequeue.position.compare_exchange_weak(
+                position, position + buffer.size(), std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    for (auto i = size_t{0}; i < buffer.size(); i++) {
+        auto& slot = this->_slots[(position + i) & MASK];
+
+        wait_for(slot, position + i + 1);
+        buffer[i] = std::move(slot.value);
+        slot.sequence.store(position + i + Capacity, std::memory_order_release);
+    }
+
+    this->_stats.consumer.transferred_bulk(buffer.size());
+    this->wake_producers();
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Push value, blocking until there's space for it.
+///
+/// @return Error::Closed if the buffer was closed first.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::push_wait(T value) noexcept
+    -> std::expected<void, Error> {
+    return this->push_until(std::move(value), std::nullopt);
+}
+
+/// @brief Push value, blocking for up to timeout until there's space for it.
+///
+/// @return Error::Full if the timeout expired first, or Error::Closed if the buffer was closed.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::push_wait_for(
+    T value, const std::chrono::nanoseconds timeout) noexcept
+    -> std::expected<void, Error> {
+    return this->push_until(std::move(value), std::chrono::steady_clock::now() + timeout);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Pop an element, blocking until one is available.
+///
+/// @return Error::Closed if the buffer is empty and was closed.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::pop_wait() noexcept -> std::expected<T, Error> {
+    return this->pop_until(std::nullopt);
+}
+
+/// @brief Pop an element, blocking for up to timeout until one is available.
+///
+/// @return Error::Empty if the timeout expired first, or Error::Closed if the buffer is empty and
+///         was closed.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::pop_wait_for(
+    const std::chrono::nanoseconds timeout) noexcept -> std::expected<T, Error> {
+    return this->pop_until(std::chrono::steady_clock::now() + timeout);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Push value, suspending the calling coroutine until there's space for it.
+///
+/// @return An awaitable which yields Error::Closed if the buffer was closed, or Error::Cancelled
+///         if a stop was requested on token.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::async_push(T value, std::stop_token token) noexcept
+    -> PushAwaitable<MpmcRingBuffer, T> {
+    return {*this, std::move(value), std::move(token)};
+}
+
+/// @brief Pop an element, suspending the calling coroutine until one is available.
+///
+/// @return An awaitable which yields Error::Closed if the buffer is empty and was closed, or
+///         Error::Cancelled if a stop was requested on token.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::async_pop(std::stop_token token) noexcept
+    -> PopAwaitable<MpmcRingBuffer, T> {
+    return {*this, std::move(token)};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Close the buffer, failing every waiting push and any pop which finds it empty.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::close() noexcept -> void {
+    this->_closed.store(true, std::memory_order_release);
+
+    this->wake_producers();
+    this->wake_consumers();
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::closed() const noexcept -> bool {
+    return this->_closed.load(std::memory_order_acquire);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::empty() const noexcept -> bool {
+    return this->size() == 0;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::full() const noexcept -> bool {
+    return this->size() == Capacity;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::size() const noexcept -> size_t {
+    const auto read = this->_dequeue.position.load(std::memory_order_acquire);
+    const auto write = this->_enqueue.position.load(std::memory_order_acquire);
+    const auto size = distance(read, write);
+
+    // The counters are read separately so the result has to be clamped.
+    if (size < 0) {
+        return 0;
+    }
+
+    return std::min(static_cast<size_t>(size), Capacity);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::free() const noexcept -> size_t {
+    return Capacity - this->size();
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::capacity() const noexcept -> size_t {
+    return Capacity;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Get the counters recorded by the Stats policy.
+///
+/// May be called from any thread.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto MpmcRingBuffer<T, Capacity, StatsPolicy>::stats() const noexcept -> BufferStats
+    requires StatsPolicy::template Recorder<Sharing::Multi>::ENABLED
+{
+    return this->_stats.snapshot();
+}
+
+}
+
+/*------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <expected>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "ringbuf.hpp"
+
+namespace core::ringbuf {
+
+/// Ring buffer which overwrites its oldest elements instead of rejecting new ones when full.
+///
+/// Intended for flight recorders and telemetry where the producer must never fail or block.
+/// Pushing is O(1) regardless of how full the buffer is, and the number of elements lost to
+/// overwriting is kept in dropped(). Everything other than pushing behaves as RingBuffer.
+///
+/// RingBuffer is a private base so that its writes, which fail when the buffer is full, can't be
+/// reached by converting to it. Only its reading and query members are exposed.
+template<typename T, size_t Capacity>
+struct OverwriteRingBuffer: private RingBuffer<T, Capacity> {
+    constexpr OverwriteRingBuffer() noexcept
+        requires(Capacity != std::dynamic_extent)
+    = default;
+
+    using RingBuffer<T, Capacity>::begin;
+    using RingBuffer<T, Capacity>::end;
+    using RingBuffer<T, Capacity>::segments;
+
+    using RingBuffer<T, Capacity>::pop;
+    using RingBuffer<T, Capacity>::pop_unchecked;
+    using RingBuffer<T, Capacity>::pop_buffer;
+
+    using RingBuffer<T, Capacity>::peek_read;
+    using RingBuffer<T, Capacity>::consume;
+
+    using RingBuffer<T, Capacity>::drain;
+    using RingBuffer<T, Capacity>::drain_all;
+
+    using RingBuffer<T, Capacity>::clear;
+
+    using RingBuffer<T, Capacity>::empty;
+    using RingBuffer<T, Capacity>::full;
+
+    using RingBuffer<T, Capacity>::size;
+    using RingBuffer<T, Capacity>::free;
+    using RingBuffer<T, Capacity>::capacity;
+
+    using RingBuffer<T, Capacity>::stats;
+
+    static auto create(size_t capacity,
+                       std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        noexcept -> std::expected<OverwriteRingBuffer, Error>
+        requires(Capacity == std::dynamic_extent);
+
+    auto push(const T& value) noexcept(std::is_nothrow_copy_constructible_v<T>) -> void;
+    auto push(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>) -> void;
+
+    template<typename... Args>
+        requires std::constructible_from<T, Args...>
+    auto emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) -> void;
+
+    auto push_buffer(std::span<const T> buffer) noexcept(std::is_nothrow_copy_constructible_v<T>)
+        -> void;
+
+    auto dropped() const noexcept -> size_t;
+
+private:
+    using Base = RingBuffer<T, Capacity>;
+
+    explicit OverwriteRingBuffer(Base&& base) noexcept;
+
+    auto make_space(size_t count) noexcept -> void;
+
+    size_t _dropped{};
+};
+
+template<typename T>
+using DynamicOverwriteRingBuffer = OverwriteRingBuffer<T, std::dynamic_extent>;
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity>
+OverwriteRingBuffer<T, Capacity>::OverwriteRingBuffer(Base&& base) noexcept :
+    Base{std::move(base)} {}
+
+/// @brief Create a buffer with a runtime capacity.
+///
+/// @return The buffer or Error::Alloc if the storage couldn't be allocated.
+template<typename T, size_t Capacity>
+auto OverwriteRingBuffer<T, Capacity>::create(const size_t capacity,
+                                              std::pmr::memory_resource* const resource) noexcept
+    -> std::expected<OverwriteRingBuffer, Error>
+    requires(Capacity == std::dynamic_extent)
+{
+    auto base = Base::create(capacity, resource);
+    if (!base) {
+        return std::unexpected{base.error()};
+    }
+
+    return OverwriteRingBuffer(std::move(*base));
+}
+
+////////////////////////////////////////////////////////////////
+
+/// Drop the oldest elements until there's space for count more. count must not exceed capacity().
+template<typename T, size_t Capacity>
+auto OverwriteRingBuffer<T, Capacity>::make_space(const size_t count) noexcept -> void {
+    const auto free = this->free();
+
+    if (count > free) {
+        static_cast<void>(this->consume(count - free));
+        this->_dropped += count - free;
+    }
+}
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity>
+auto OverwriteRingBuffer<T, Capacity>::push(const T& value) noexcept(
+    std::is_nothrow_copy_constructible_v<T>) -> void {
+    this->emplace(value);
+}
+
+template<typename T, size_t Capacity>
+auto OverwriteRingBuffer<T, Capacity>::push(T&& value) noexcept(
+    std::is_nothrow_move_constructible_v<T>) -> void {
+    this->emplace(std::move(value));
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Construct an element in place at the back of the buffer, dropping the oldest element
+/// if the buffer is full.
+///
+/// args must not refer to an element of the buffer.
+template<typename T, size_t Capacity>
+template<typename... Args>
+    requires std::constructible_from<T, Args...>
+auto OverwriteRingBuffer<T, Capacity>::emplace(Args&&... args) noexcept(
+    std::is_nothrow_constructible_v<T, Args...>) -> void {
+    this->make_space(1);
+    static_cast<void>(Base::emplace(std::forward<Args>(args)...));
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Write buffer to the back of the buffer, dropping as many of the oldest elements as
+/// needed to make space.
+///
+/// If buffer is larger than capacity(), only its last capacity() elements are kept.
+template<typename T, size_t Capacity>
+auto OverwriteRingBuffer<T, Capacity>::push_buffer(const std::span<const T> buffer) noexcept(
+    std::is_nothrow_copy_constructible_v<T>) -> void {
+    if (buffer.size() >= this->capacity()) {
+        this->_dropped += this->size() + (buffer.size() - this->capacity());
+        this->clear();
+
+        static_cast<void>(Base::push_buffer(buffer.last(this->capacity())));
+        return;
+    }
+
+    this->make_space(buffer.size());
+    static_cast<void>(Base::push_buffer(buffer));
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Get the number of elements that have been overwritten before being read.
+template<typename T, size_t Capacity>
+auto OverwriteRingBuffer<T, Capacity>::dropped() const noexcept -> size_t {
+    return this->_dropped;
+}
+
+}
+
+/*------------------------------------------------------------------------------------------------*/
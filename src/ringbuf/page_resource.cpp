@@ -0,0 +1,113 @@
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <new>
+
+#include "page_resource.hpp"
+
+namespace {
+
+#if defined(__linux__)
+/// From <numaif.h>, which is part of libnuma rather than libc.
+constexpr auto MPOL_BIND = 2;
+
+auto page_size() noexcept -> size_t {
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+/// Bind memory to a NUMA node. Kernels built without NUMA support only have one node, so there's
+/// nothing to bind to and ENOSYS isn't treated as a failure.
+auto bind(void* const memory, const size_t size, const unsigned node) noexcept -> bool {
+    constexpr auto MASK_BITS = sizeof(unsigned long) * 8;
+
+    if (node >= MASK_BITS) {
+        return false;
+    }
+
+    const auto mask = 1UL << node;
+    const auto result = syscall(SYS_mbind, memory, size, MPOL_BIND, &mask, MASK_BITS, 0);
+
+    return result == 0 || errno == ENOSYS;
+}
+#endif
+
+}
+
+core::ringbuf::PageResource::PageResource(const Options options) noexcept : _options{options} {}
+
+auto core::ringbuf::PageResource::options() const noexcept -> const Options& {
+    return this->_options;
+}
+
+auto core::ringbuf::PageResource::mapping_size(const size_t bytes) const noexcept -> size_t {
+#if defined(__linux__)
+    const auto granularity = this->_options.huge_pages ? HUGE_PAGE_SIZE : page_size();
+#else
+    const auto granularity = size_t{1};
+#endif
+
+    return ((std::max(bytes, size_t{1}) + granularity - 1) / granularity) * granularity;
+}
+
+auto core::ringbuf::PageResource::do_allocate(const size_t bytes, const size_t alignment)
+    -> void* {
+#if defined(__linux__)
+    if (alignment > page_size()) {
+        throw std::bad_alloc();
+    }
+
+    const auto size = this->mapping_size(bytes);
+    const auto protection = PROT_READ | PROT_WRITE;
+    const auto flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+    auto* memory = MAP_FAILED;
+
+    if (this->_options.huge_pages) {
+        memory = mmap(nullptr, size, protection, flags | MAP_HUGETLB, -1, 0);
+    }
+
+    if (memory == MAP_FAILED) {
+        memory = mmap(nullptr, size, protection, flags, -1, 0);
+
+        if (memory == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        if (this->_options.huge_pages) {
+            madvise(memory, size, MADV_HUGEPAGE);
+        }
+    }
+
+    if (this->_options.numa_node && !bind(memory, size, *this->_options.numa_node)) {
+        munmap(memory, size);
+        throw std::bad_alloc();
+    }
+
+    return memory;
+#else
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+#endif
+}
+
+auto core::ringbuf::PageResource::do_deallocate(void* const memory,
+                                                const size_t bytes,
+                                                const size_t alignment) -> void {
+#if defined(__linux__)
+    static_cast<void>(alignment);
+    munmap(memory, this->mapping_size(bytes));
+#else
+    std::pmr::new_delete_resource()->deallocate(memory, bytes, alignment);
+#endif
+}
+
+auto core::ringbuf::PageResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    -> bool {
+    const auto* const resource = dynamic_cast<const PageResource*>(&other);
+
+    return resource != nullptr && resource->_options.huge_pages == this->_options.huge_pages;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+
+namespace core::ringbuf {
+
+/// Memory resource that maps whole pages directly from the kernel.
+///
+/// Intended for large DynamicRingBuffer storage. Allocations can be backed by huge pages and bound
+/// to a NUMA node. Without a node, pages are placed by the kernel's first-touch policy, i.e. local
+/// to the thread that first writes them. Only functional on Linux, elsewhere it falls back to
+/// std::pmr::new_delete_resource().
+struct PageResource: std::pmr::memory_resource {
+    struct Options {
+        /// Back allocations with huge pages. Explicit huge pages are tried first, falling back to
+        /// regular pages marked as eligible for transparent huge pages.
+        bool huge_pages = false;
+
+        /// NUMA node to bind allocations to.
+        std::optional<unsigned> numa_node = std::nullopt;
+    };
+
+    /// Size allocations are rounded to when huge pages are requested.
+    static constexpr auto HUGE_PAGE_SIZE = size_t{2} * 1024 * 1024;
+
+    PageResource() noexcept = default;
+    explicit PageResource(Options options) noexcept;
+
+    auto options() const noexcept -> const Options&;
+
+private:
+    auto do_allocate(size_t bytes, size_t alignment) -> void* override;
+    auto do_deallocate(void* memory, size_t bytes, size_t alignment) -> void override;
+    auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override;
+
+    auto mapping_size(size_t bytes) const noexcept -> size_t;
+
+    Options _options{};
+};
+
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "algorithm.hpp"
+#include "segments.hpp"
+
+namespace core::ringbuf {
+
+/// One of the standard execution policies, such as std::execution::par.
+template<typename E>
+concept ExecutionPolicy = std::is_execution_policy_v<std::remove_cvref_t<E>>;
+
+namespace parallel_impl {
+
+/// Fewest elements worth handing to another thread.
+inline constexpr auto MIN_CHUNK = size_t{4096};
+
+/// Chunks per hardware thread, so threads which finish early can pick up another.
+inline constexpr auto CHUNKS_PER_THREAD = size_t{4};
+
+template<typename E>
+inline constexpr auto PARALLEL =
+    std::is_same_v<std::remove_cvref_t<E>, std::execution::parallel_policy>
+    || std::is_same_v<std::remove_cvref_t<E>, std::execution::parallel_unsequenced_policy>;
+
+/// A contiguous run of elements and its position within the whole range.
+template<typename T>
+struct Chunk {
+    std::span<T> elements{};
+    size_t offset{};
+};
+
+/// @brief Split segments into chunks of roughly equal size, none of which crosses the wrap.
+///
+/// Aims for CHUNKS_PER_THREAD chunks per hardware thread, but no more than one per MIN_CHUNK
+/// elements. A chunk which would cross the wrap is cut in two there.
+template<typename T>
+auto split(const Segments<T> segments) -> std::vector<Chunk<T>> {
+    const auto size = segments.size();
+    const auto threads = std::max(size_t{std::thread::hardware_concurrency()}, size_t{1});
+    const auto count = std::clamp(size / MIN_CHUNK, size_t{1}, threads * CHUNKS_PER_THREAD);
+    const auto chunk_size = std::max((size + count - 1) / count, size_t{1});
+
+    auto chunks = std::vector<Chunk<T>>{};
+    chunks.reserve(count + 1);
+
+    auto offset = size_t{0};
+
+    for (const auto segment : {segments.first, segments.second}) {
+        for (auto start = size_t{0}; start < segment.size(); start += chunk_size) {
+            const auto length = std::min(chunk_size, segment.size() - start);
+
+            chunks.push_back(Chunk<T>{segment.subspan(start, length), offset});
+            offset += length;
+        }
+    }
+
+    return chunks;
+}
+
+}
+
+/// @brief Call function with each element of range, under an execution policy.
+///
+/// With std::execution::par or par_unseq the segments are split into contiguous chunks which are
+/// spread across threads, so each thread runs a plain loop over a span rather than stepping an
+/// Iterator. With seq or unseq each segment is passed to std::for_each() with the policy. As with
+/// the standard algorithms, function may be called concurrently and in no particular order.
+///
+/// How many threads actually run depends on the standard library's parallel backend. For GCC that
+/// means linking against TBB, otherwise the parallel policies run on the calling thread.
+template<ExecutionPolicy E, SegmentedRange R, typename F>
+auto for_each(E&& policy, R&& range, F function) -> void {
+    const auto segments = range.segments();
+
+    if constexpr (!parallel_impl::PARALLEL<E>) {
+        std::for_each(policy, segments.first.begin(), segments.first.end(), function);
+        std::for_each(policy, segments.second.begin(), segments.second.end(), function);
+    } else {
+        const auto chunks = parallel_impl::split(segments);
+
+        std::for_each(policy, chunks.begin(), chunks.end(), [&](const auto& chunk) {
+            std::for_each(chunk.elements.begin(), chunk.elements.end(), function);
+        });
+    }
+}
+
+/// @brief Write operation applied to each element of range to output, under an execution policy.
+///
+/// Parallel policies split the range as for_each() does, and each chunk writes to its own part of
+/// output.
+///
+/// @return An iterator one past the last element written.
+template<ExecutionPolicy E, SegmentedRange R, std::random_access_iterator O, typename F>
+auto transform(E&& policy, R&& range, O output, F operation) -> O {
+    const auto segments = range.segments();
+
+    if constexpr (!parallel_impl::PARALLEL<E>) {
+        output = std::transform(
+            policy, segments.first.begin(), segments.first.end(), std::move(output), operation);
+        return std::transform(
+            policy, segments.second.begin(), segments.second.end(), std::move(output), operation);
+    } else {
+        const auto chunks = parallel_impl::split(segments);
+
+        std::for_each(policy, chunks.begin(), chunks.end(), [&](const auto& chunk) {
+            const auto destination = std::next(output, static_cast<std::ptrdiff_t>(chunk.offset));
+            std::transform(chunk.elements.begin(), chunk.elements.end(), destination, operation);
+        });
+
+        return std::next(output, static_cast<std::ptrdiff_t>(segments.size()));
+    }
+}
+
+/// @brief Combine the elements of range and init using operation, under an execution policy.
+///
+/// Like std::reduce(), the elements may be combined in any order and grouping, so operation must
+/// be associative and commutative. Use accumulate() for an ordered fold. Parallel policies reduce
+/// each chunk on its own thread and then combine the results.
+template<ExecutionPolicy E, SegmentedRange R, typename T, typename Op = std::plus<>>
+auto reduce(E&& policy, R&& range, T init, Op operation = {}) -> T {
+    const auto segments = range.segments();
+
+    if constexpr (!parallel_impl::PARALLEL<E>) {
+        init = std::reduce(
+            policy, segments.first.begin(), segments.first.end(), std::move(init), operation);
+        return std::reduce(
+            policy, segments.second.begin(), segments.second.end(), std::move(init), operation);
+    } else {
+        if (segments.empty()) {
+            return init;
+        }
+
+        const auto chunks = parallel_impl::split(segments);
+
+        // Chunks are never empty, so each can be seeded with its own first element.
+        const auto reduce_chunk = [&](const auto& chunk) {
+            const auto& elements = chunk.elements;
+            return std::reduce(
+                std::next(elements.begin()), elements.end(), T(elements.front()), operation);
+        };
+
+        return std::transform_reduce(
+            policy, chunks.begin(), chunks.end(), std::move(init), operation, reduce_chunk);
+    }
+}
+
+}
@@ -1,12 +1,23 @@
 #pragma once
 
-#include <array>
+#include <algorithm>
+#include <bit>
 #include <cstddef>
 #include <expected>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 #include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
+#include "copy.hpp"
 #include "error.hpp"
 #include "iterator.hpp"
+#include "segments.hpp"
+#include "stats.hpp"
+#include "storage.hpp"
 
 namespace core::ringbuf {
 
@@ -22,28 +33,73 @@ struct Sentinel;
 ////////////////////////////////////////////////////////////////
 
 namespace core::ringbuf::error {
-struct Full: ::error::Error {};
-struct Empty: ::error::Error {};
+struct Full: ::error::TrivialError {};
+struct Empty: ::error::TrivialError {};
+struct Alloc: ::error::TrivialError {};
+struct Closed: ::error::TrivialError {};
+struct Cancelled: ::error::TrivialError {};
+struct Io: ::error::TrivialError {};
+struct Layout: ::error::TrivialError {};
+struct Contended: ::error::TrivialError {};
 }
 
 ERROR_DERIVE_FMT(core::ringbuf::error::Full, "Buffer full");
 ERROR_DERIVE_FMT(core::ringbuf::error::Empty, "Buffer empty");
+ERROR_DERIVE_FMT(core::ringbuf::error::Alloc, "Buffer allocation failed");
+ERROR_DERIVE_FMT(core::ringbuf::error::Closed, "Buffer closed");
+ERROR_DERIVE_FMT(core::ringbuf::error::Cancelled, "Operation cancelled");
+ERROR_DERIVE_FMT(core::ringbuf::error::Io, "I/O failed");
+ERROR_DERIVE_FMT(core::ringbuf::error::Layout, "Buffer layout mismatch");
+ERROR_DERIVE_FMT(core::ringbuf::error::Contended, "Lost a race with another thread");
 
 static_assert(error::ErrorType<core::ringbuf::error::Full>);
 static_assert(error::ErrorType<core::ringbuf::error::Empty>);
+static_assert(error::ErrorType<core::ringbuf::error::Alloc>);
+static_assert(error::ErrorType<core::ringbuf::error::Closed>);
+static_assert(error::ErrorType<core::ringbuf::error::Cancelled>);
+static_assert(error::ErrorType<core::ringbuf::error::Io>);
+static_assert(error::ErrorType<core::ringbuf::error::Layout>);
+static_assert(error::ErrorType<core::ringbuf::error::Contended>);
 
 namespace core::ringbuf {
 
-struct Error: ::error::Variant<error::Full, error::Empty> {
+struct Error: ::error::Variant<error::Full,
+                               error::Empty,
+                               error::Alloc,
+                               error::Closed,
+                               error::Cancelled,
+                               error::Io,
+                               error::Layout,
+                               error::Contended> {
     using Full = error::Full;
     using Empty = error::Empty;
-
-    using Variant = ::error::Variant<error::Full, error::Empty>;
+    using Alloc = error::Alloc;
+    using Closed = error::Closed;
+    using Cancelled = error::Cancelled;
+    using Io = error::Io;
+    using Layout = error::Layout;
+    using Contended = error::Contended;
+
+    using Variant = ::error::Variant<error::Full,
+                                     error::Empty,
+                                     error::Alloc,
+                                     error::Closed,
+                                     error::Cancelled,
+                                     error::Io,
+                                     error::Layout,
+                                     error::Contended>;
     using Variant::Variant;
 };
 
 static_assert(::error::ErrorType<Error>);
 
+// Trivial copy construction and destruction is what lets push() and pop() results be returned in
+// registers. std::expected's assignment operators aren't trivial, but they don't affect that.
+static_assert(std::is_trivially_copyable_v<Error>);
+static_assert(sizeof(Error) == 1);
+static_assert(std::is_trivially_copy_constructible_v<std::expected<void, Error>>);
+static_assert(std::is_trivially_destructible_v<std::expected<void, Error>>);
+
 }
 
 /*------------------------------------------------------------------------------------------------*/
@@ -52,234 +108,863 @@ static_assert(::error::ErrorType<Error>);
 
 namespace core::ringbuf {
 
-template<typename T, size_t Capacity>
+/// Ring buffer with either a fixed or a runtime capacity.
+///
+/// A fixed Capacity keeps the elements inline. With std::dynamic_extent the capacity is chosen at
+/// runtime through create() and the elements are allocated from a std::pmr::memory_resource.
+/// Dynamic buffers are move only, and a moved-from buffer may only be assigned to or destroyed.
+///
+/// Elements are constructed in place when they're pushed and destroyed when they're popped, so
+/// slots that aren't in use never hold a live T. A fixed buffer of a TrivialElement type is itself
+/// trivially copyable. prepare_write() and commit_write() are only available for TrivialElement
+/// types since they write straight into the unused slots.
+///
+/// Bulk transfers of TrivialElement types go through copy_elements(), which copies each contiguous
+/// segment as raw bytes. drain() and fill() batch element-wise consumers and producers instead,
+/// passing each element through a callback in place and updating the index once per batch.
+///
+/// When Capacity is a power of two the read and write indices run freely and are wrapped with a
+/// mask on access. Their difference is then always the size, so no full flag is needed. Other
+/// capacities keep the indices wrapped into [0, capacity()) and track fullness separately.
+///
+/// With StatsPolicy set to Stats the buffer counts its transfers and failures, which stats()
+/// returns. The default NoStats records nothing and takes no space.
+///
+/// A fixed buffer of a TrivialElement type can be used entirely in constant expressions, e.g. to
+/// precompute a lookup ring into read-only data. Other element types live in uninitialised storage,
+/// which can't be constructed into during constant evaluation.
+template<typename T, size_t Capacity, typename StatsPolicy = NoStats>
 struct RingBuffer {
+    constexpr RingBuffer() noexcept
+        requires(Capacity != std::dynamic_extent)
+    = default;
+
+    constexpr RingBuffer(const RingBuffer& other)
+        requires(Capacity != std::dynamic_extent && TrivialElement<T>)
+    = default;
+    constexpr RingBuffer(const RingBuffer& other) noexcept(std::is_nothrow_copy_constructible_v<T>)
+        requires(Capacity != std::dynamic_extent && !TrivialElement<T>);
+
+    constexpr RingBuffer(RingBuffer&& other)
+        requires(Capacity != std::dynamic_extent && TrivialElement<T>)
+    = default;
+    constexpr RingBuffer(RingBuffer&& other) noexcept(Capacity == std::dynamic_extent ||
+                                                      std::is_nothrow_move_constructible_v<T>);
+
+    constexpr ~RingBuffer()
+        requires std::is_trivially_destructible_v<T>
+    = default;
+    constexpr ~RingBuffer() noexcept;
+
+    constexpr auto operator=(const RingBuffer& other) -> RingBuffer&
+        requires(Capacity != std::dynamic_extent && TrivialElement<T>)
+    = default;
+    constexpr auto operator=(const RingBuffer& other) noexcept(
+        std::is_nothrow_copy_constructible_v<T>) -> RingBuffer&
+        requires(Capacity != std::dynamic_extent && !TrivialElement<T>);
+
+    constexpr auto operator=(RingBuffer&& other) -> RingBuffer&
+        requires(Capacity != std::dynamic_extent && TrivialElement<T>)
+    = default;
+    constexpr auto operator=(RingBuffer&& other) noexcept(Capacity == std::dynamic_extent ||
+                                                          std::is_nothrow_move_constructible_v<T>)
+        -> RingBuffer&;
+
+    static auto create(size_t capacity,
+                       std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        noexcept -> std::expected<RingBuffer, Error>
+        requires(Capacity == std::dynamic_extent);
+
     constexpr auto begin() noexcept -> Iterator<T>;
     constexpr auto end() const noexcept -> Sentinel;
 
-    auto push(T value) noexcept -> std::expected<void, Error>;
-    auto push_unchecked(T value) noexcept -> void;
+    constexpr auto segments() noexcept -> Segments<T>;
+    constexpr auto segments() const noexcept -> Segments<const T>;
+
+    constexpr auto push(const T& value) noexcept(std::is_nothrow_copy_constructible_v<T>)
+        -> std::expected<void, Error>;
+    constexpr auto push(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>)
+        -> std::expected<void, Error>;
+
+    constexpr auto push_unchecked(const T& value) noexcept(std::is_nothrow_copy_constructible_v<T>)
+        -> void;
+    constexpr auto push_unchecked(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>)
+        -> void;
+
+    template<typename... Args>
+        requires std::constructible_from<T, Args...>
+    constexpr auto emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+        -> std::expected<void, Error>;
+
+    constexpr auto push_buffer(std::span<const T> buffer) noexcept(
+        std::is_nothrow_copy_constructible_v<T>) -> std::expected<void, Error>;
+
+    constexpr auto pop() noexcept(std::is_nothrow_move_constructible_v<T>)
+        -> std::expected<T, Error>;
+    constexpr auto pop_unchecked() noexcept(std::is_nothrow_move_constructible_v<T>) -> T;
+
+    constexpr auto pop_buffer(std::span<T> buffer) noexcept(std::is_nothrow_move_assignable_v<T>)
+        -> std::expected<void, Error>;
+
+    constexpr auto prepare_write(size_t count) noexcept -> std::expected<Segments<T>, Error>
+        requires TrivialElement<T>;
+    constexpr auto commit_write(size_t count) noexcept -> std::expected<void, Error>
+        requires TrivialElement<T>;
+
+    constexpr auto peek_read() const noexcept -> Segments<const T>;
+    constexpr auto consume(size_t count) noexcept -> std::expected<void, Error>;
+
+    template<typename F>
+        requires std::invocable<F&, T&>
+    constexpr auto drain(size_t max, F&& function) noexcept(std::is_nothrow_invocable_v<F&, T&>)
+        -> size_t;
 
-    auto push_buffer(std::span<const T> buffer) noexcept -> std::expected<void, Error>;
+    template<typename F>
+        requires std::invocable<F&, T&>
+    constexpr auto drain_all(F&& function) noexcept(std::is_nothrow_invocable_v<F&, T&>) -> size_t;
 
-    auto pop() noexcept -> std::expected<T, Error>;
-    auto pop_unchecked() noexcept -> T;
+    template<typename G>
+        requires std::constructible_from<T, std::invoke_result_t<G&>>
+    constexpr auto fill(size_t max, G&& generator) noexcept(NOTHROW_GENERATOR<G>) -> size_t;
 
-    auto pop_buffer(std::span<T> buffer) noexcept -> std::expected<void, Error>;
+    constexpr auto clear() noexcept -> void;
 
-    auto clear() noexcept -> void;
+    constexpr auto empty() const noexcept -> bool;
+    constexpr auto full() const noexcept -> bool;
 
-    auto empty() const noexcept -> bool;
-    auto full() const noexcept -> bool;
+    constexpr auto size() const noexcept -> size_t;
+    constexpr auto free() const noexcept -> size_t;
+    constexpr auto capacity() const noexcept -> size_t;
 
-    auto size() const noexcept -> size_t;
-    auto free() const noexcept -> size_t;
-    auto capacity() const noexcept -> size_t;
+    constexpr auto stats() const noexcept -> BufferStats
+        requires StatsPolicy::template Recorder<Sharing::None>::ENABLED;
 
 private:
-    std::array<T, Capacity> _buffer{};
+    static constexpr auto DYNAMIC = Capacity == std::dynamic_extent;
+    static constexpr auto FREE_RUNNING = !DYNAMIC && std::has_single_bit(Capacity);
+
+    template<typename G>
+    static constexpr auto NOTHROW_GENERATOR =
+        std::is_nothrow_invocable_v<G&> &&
+        std::is_nothrow_constructible_v<T, std::invoke_result_t<G&>>;
+
+    explicit RingBuffer(Storage<T, Capacity>&& storage) noexcept;
+
+    static constexpr auto wrap(size_t index) noexcept -> size_t;
+
+    constexpr auto slot(size_t offset) const noexcept -> size_t;
+
+    constexpr auto advance_write(size_t count) noexcept -> void;
+    constexpr auto advance_read(size_t count) noexcept -> void;
+
+    constexpr auto record_push(size_t count) noexcept -> void;
+
+    template<typename Other>
+    constexpr auto take(Other&& other) -> void;
+    constexpr auto destroy_front(size_t count) noexcept -> void;
+
+    template<typename U>
+    static constexpr auto split(std::span<U, Capacity> buffer,
+                                size_t start,
+                                size_t count) noexcept -> Segments<U>;
+
+    Storage<T, Capacity> _buffer{};
     size_t _write_ptr{};
     size_t _read_ptr{};
-    bool _is_full{};
+
+    /// Only needed to tell a full buffer from an empty one when the indices are wrapped.
+    [[no_unique_address]] std::conditional_t<FREE_RUNNING, std::tuple<>, bool> _is_full{};
+
+    [[no_unique_address]] StatsPolicy::template Recorder<Sharing::None> _stats{};
 
     friend struct Iterator<T>;
     friend struct Sentinel;
 };
 
+template<typename T, typename StatsPolicy = NoStats>
+using DynamicRingBuffer = RingBuffer<T, std::dynamic_extent, StatsPolicy>;
+
 static_assert(std::ranges::range<RingBuffer<int, 8>>);
 static_assert(std::ranges::random_access_range<RingBuffer<int, 8>>);
 static_assert(std::ranges::sized_range<RingBuffer<int, 8>>);
+static_assert(std::is_trivially_copyable_v<RingBuffer<int, 8>>);
+static_assert(std::is_trivially_copyable_v<RingBuffer<int, 8, Stats>>);
+static_assert(sizeof(RingBuffer<int, 8>) == sizeof(int) * 8 + 2 * sizeof(size_t));
+
+static_assert(std::ranges::random_access_range<DynamicRingBuffer<int>>);
+static_assert(std::ranges::sized_range<DynamicRingBuffer<int>>);
 
 /*------------------------------------------------------------------------------------------------*/
 // Class method definitions.
 /*------------------------------------------------------------------------------------------------*/
 
-template<typename T, size_t Capacity>
-constexpr auto RingBuffer<T, Capacity>::begin() noexcept -> Iterator<T> {
-    return Iterator<T>(std::span<T, std::dynamic_extent>{this->_buffer}, this->_read_ptr, 0);
+template<typename T, size_t Capacity, typename StatsPolicy>
+RingBuffer<T, Capacity, StatsPolicy>::RingBuffer(Storage<T, Capacity>&& storage) noexcept :
+    _buffer{std::move(storage)} {}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr RingBuffer<T, Capacity, StatsPolicy>::RingBuffer(const RingBuffer& other) noexcept(
+    std::is_nothrow_copy_constructible_v<T>)
+    requires(Capacity != std::dynamic_extent && !TrivialElement<T>)
+{
+    this->take(other);
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr RingBuffer<T, Capacity, StatsPolicy>::RingBuffer(RingBuffer&& other) noexcept(
+    Capacity == std::dynamic_extent || std::is_nothrow_move_constructible_v<T>) {
+    this->take(std::move(other));
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr RingBuffer<T, Capacity, StatsPolicy>::~RingBuffer() noexcept {
+    this->destroy_front(this->size());
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::operator=(const RingBuffer& other) noexcept(
+    std::is_nothrow_copy_constructible_v<T>) -> RingBuffer&
+    requires(Capacity != std::dynamic_extent && !TrivialElement<T>)
+{
+    if (this != &other) {
+        this->clear();
+        this->take(other);
+    }
+
+    return *this;
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::operator=(RingBuffer&& other) noexcept(
+    Capacity == std::dynamic_extent || std::is_nothrow_move_constructible_v<T>) -> RingBuffer& {
+    if (this != &other) {
+        this->clear();
+        this->take(std::move(other));
+    }
+
+    return *this;
 }
 
-template<typename T, size_t Capacity>
-constexpr auto RingBuffer<T, Capacity>::end() const noexcept -> Sentinel {
-    if (this->_write_ptr < this->_read_ptr || this->full()) {
-        return Sentinel(this->_write_ptr, 1);
+/// @brief Create a buffer with a runtime capacity.
+///
+/// @param capacity Number of elements the buffer can hold. Must be non-zero.
+/// @param resource Memory resource the elements are allocated from.
+///
+/// @return The buffer or Error::Alloc if the storage couldn't be allocated.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto RingBuffer<T, Capacity, StatsPolicy>::create(
+    const size_t capacity, std::pmr::memory_resource* const resource) noexcept
+    -> std::expected<RingBuffer, Error>
+    requires(Capacity == std::dynamic_extent)
+{
+    if (capacity == 0) {
+        return std::unexpected{Error::Alloc()};
     }
 
-    return Sentinel(this->_write_ptr, 0);
+    try {
+        return RingBuffer(Storage<T, Capacity>(capacity, resource));
+    } catch (...) {
+        return std::unexpected{Error::Alloc()};
+    }
 }
 
 ////////////////////////////////////////////////////////////////
 
-template<typename T, size_t Capacity>
-auto RingBuffer<T, Capacity>::push(const T value) noexcept -> std::expected<void, Error> {
-    if (this->_is_full) {
-        return std::unexpected{Error::Full()};
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::wrap(const size_t index) noexcept -> size_t {
+    if constexpr (FREE_RUNNING) {
+        return index & (Capacity - 1);
+    } else {
+        return index;
+    }
+}
+
+/// Get the wrapped index of the element offset places from the front of the buffer.
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::slot(const size_t offset) const noexcept
+    -> size_t {
+    if constexpr (FREE_RUNNING) {
+        return wrap(this->_read_ptr + offset);
+    } else {
+        const auto index = this->_read_ptr + offset;
+        return index >= this->capacity() ? index - this->capacity() : index;
+    }
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::advance_write(const size_t count) noexcept
+    -> void {
+    if constexpr (FREE_RUNNING) {
+        this->_write_ptr += count;
+    } else {
+        this->_write_ptr = (this->_write_ptr + count) % this->capacity();
+
+        if (count > 0 && this->_write_ptr == this->_read_ptr) {
+            this->_is_full = true;
+        }
     }
+}
 
-    this->_buffer[this->_write_ptr++] = value;
-    this->_write_ptr = this->_write_ptr % Capacity;
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::advance_read(const size_t count) noexcept
+    -> void {
+    if constexpr (FREE_RUNNING) {
+        this->_read_ptr += count;
+    } else {
+        this->_read_ptr = (this->_read_ptr + count) % this->capacity();
 
-    if (this->_write_ptr == this->_read_ptr) {
-        this->_is_full = true;
+        if (count > 0) {
+            this->_is_full = false;
+        }
     }
+}
 
-    return {};
+/// Record count elements pushed individually, and the size they brought the buffer to.
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::record_push(const size_t count) noexcept
+    -> void {
+    this->_stats.producer.transferred(count);
+    this->_stats.producer.occupancy(this->size());
+}
+
+/// @brief Copy or move the contents of other into this buffer, which must be empty.
+///
+/// Elements keep the same slots they had in other. A moved-from dynamic buffer is left without any
+/// storage, and a moved-from fixed buffer is left empty.
+template<typename T, size_t Capacity, typename StatsPolicy>
+template<typename Other>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::take(Other&& other) -> void {
+    constexpr auto MOVE = !std::is_lvalue_reference_v<Other>;
+
+    if constexpr (DYNAMIC && MOVE) {
+        std::swap(this->_buffer, other._buffer);
+        std::swap(this->_write_ptr, other._write_ptr);
+        std::swap(this->_read_ptr, other._read_ptr);
+        std::swap(this->_is_full, other._is_full);
+        std::swap(this->_stats, other._stats);
+    } else {
+        auto constructed = size_t{0};
+
+        try {
+            for (; constructed < other.size(); constructed++) {
+                auto& source = other._buffer[other.slot(constructed)];
+
+                if constexpr (MOVE) {
+                    std::construct_at(std::addressof(this->_buffer[other.slot(constructed)]),
+                                      std::move(source));
+                } else {
+                    std::construct_at(std::addressof(this->_buffer[other.slot(constructed)]),
+                                      source);
+                }
+            }
+        } catch (...) {
+            for (auto i = size_t{0}; i < constructed; i++) {
+                std::destroy_at(std::addressof(this->_buffer[other.slot(i)]));
+            }
+
+            throw;
+        }
+
+        this->_write_ptr = other._write_ptr;
+        this->_read_ptr = other._read_ptr;
+        this->_is_full = other._is_full;
+        this->_stats = other._stats;
+
+        if constexpr (MOVE) {
+            other.clear();
+        }
+    }
+}
+
+/// Destroy count elements from the front of the buffer without removing them.
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::destroy_front(const size_t count) noexcept
+    -> void {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        const auto live = split(this->_buffer.span(), wrap(this->_read_ptr), count);
+
+        std::destroy(live.first.begin(), live.first.end());
+        std::destroy(live.second.begin(), live.second.end());
+    }
+}
+
+/// Split count elements of buffer, starting at the wrapped index start, into contiguous segments.
+template<typename T, size_t Capacity, typename StatsPolicy>
+template<typename U>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::split(const std::span<U, Capacity> buffer,
+                                                           const size_t start,
+                                                           const size_t count) noexcept
+    -> Segments<U> {
+    const auto until_wrap = buffer.size() - start;
+
+    if (count > until_wrap) {
+        return Segments<U>{buffer.subspan(start), buffer.first(count - until_wrap)};
+    }
+
+    return Segments<U>{buffer.subspan(start, count), {}};
+}
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::begin() noexcept -> Iterator<T> {
+    return Iterator<T>(this->_buffer.span(), wrap(this->_read_ptr), 0);
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::end() const noexcept -> Sentinel {
+    const auto write_ptr = wrap(this->_write_ptr);
+
+    if (write_ptr < wrap(this->_read_ptr) || this->full()) {
+        return Sentinel(write_ptr, 1);
+    }
+
+    return Sentinel(write_ptr, 0);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Get the contents of the buffer as up to two contiguous spans, oldest first.
+///
+/// Loops over the spans avoid the wrap handling of Iterator and can be vectorised. See
+/// algorithm.hpp for algorithms built on this. The segments remain valid until the buffer is next
+/// modified.
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::segments() noexcept -> Segments<T> {
+    return split(this->_buffer.span(), wrap(this->_read_ptr), this->size());
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::segments() const noexcept
+    -> Segments<const T> {
+    return split(this->_buffer.span(), wrap(this->_read_ptr), this->size());
+}
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::push(const T& value) noexcept(
+    std::is_nothrow_copy_constructible_v<T>) -> std::expected<void, Error> {
+    return this->emplace(value);
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::push(T&& value) noexcept(
+    std::is_nothrow_move_constructible_v<T>) -> std::expected<void, Error> {
+    return this->emplace(std::move(value));
 }
 
 /*------------------------------------------------------------------------------------------------*/
 
-template<typename T, size_t Capacity>
-auto RingBuffer<T, Capacity>::push_unchecked(const T value) noexcept -> void {
-    this->_buffer[this->_write_ptr++] = value;
-    this->_write_ptr = this->_write_ptr % Capacity;
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::push_unchecked(const T& value) noexcept(
+    std::is_nothrow_copy_constructible_v<T>) -> void {
+    std::construct_at(std::addressof(this->_buffer[wrap(this->_write_ptr)]), value);
+    this->advance_write(1);
+    this->record_push(1);
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::push_unchecked(T&& value) noexcept(
+    std::is_nothrow_move_constructible_v<T>) -> void {
+    std::construct_at(std::addressof(this->_buffer[wrap(this->_write_ptr)]), std::move(value));
+    this->advance_write(1);
+    this->record_push(1);
+}
+
+/*------------------------------------------------------------------------------------------------*/
 
-    if (this->_write_ptr == this->_read_ptr) {
-        this->_is_full = true;
+/// @brief Construct an element in place at the back of the buffer.
+///
+/// @return Error::Full if there's no space, in which case args are left untouched.
+template<typename T, size_t Capacity, typename StatsPolicy>
+template<typename... Args>
+    requires std::constructible_from<T, Args...>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::emplace(Args&&... args) noexcept(
+    std::is_nothrow_constructible_v<T, Args...>) -> std::expected<void, Error> {
+    if (this->full()) {
+        this->_stats.producer.failed();
+        return std::unexpected{Error::Full()};
     }
+
+    std::construct_at(std::addressof(this->_buffer[wrap(this->_write_ptr)]),
+                      std::forward<Args>(args)...);
+    this->advance_write(1);
+    this->record_push(1);
+
+    return {};
 }
 
 /*------------------------------------------------------------------------------------------------*/
 
-template<typename T, size_t Capacity>
-auto RingBuffer<T, Capacity>::push_buffer(const std::span<const T> buffer) noexcept
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::push_buffer(
+    const std::span<const T> buffer) noexcept(std::is_nothrow_copy_constructible_v<T>)
     -> std::expected<void, Error> {
     if (buffer.size() > this->free()) {
-        if (this->_is_full) {
-            return std::unexpected{Error::Full()};
-        }
+        this->_stats.producer.failed();
         return std::unexpected{Error::Full()};
     }
 
-    const auto space_until_wrap = Capacity - this->_write_ptr;
+    const auto write_ptr = wrap(this->_write_ptr);
+    const auto space_until_wrap = this->capacity() - write_ptr;
+    const auto storage = this->_buffer.span();
+
+    if constexpr (TrivialElement<T>) {
+        const auto free = split(storage, write_ptr, buffer.size());
+
+        copy_elements(buffer.first(free.first.size()), free.first.data());
+        copy_elements(buffer.last(free.second.size()), free.second.data());
 
-    if (buffer.size() > space_until_wrap) {
+    } else if (buffer.size() > space_until_wrap) {
         const auto chunk1 = buffer.first(space_until_wrap);
         const auto chunk2 = buffer.last(buffer.size() - space_until_wrap);
 
-        std::copy(chunk1.begin(), chunk1.end(), std::next(this->_buffer.begin(), this->_write_ptr));
-        std::copy(chunk2.begin(), chunk2.end(), this->_buffer.begin());
+        const auto first = std::next(storage.begin(), write_ptr);
+        const auto last = std::uninitialized_copy(chunk1.begin(), chunk1.end(), first);
+
+        if constexpr (std::is_nothrow_copy_constructible_v<T>) {
+            std::uninitialized_copy(chunk2.begin(), chunk2.end(), storage.begin());
+        } else {
+            try {
+                std::uninitialized_copy(chunk2.begin(), chunk2.end(), storage.begin());
+            } catch (...) {
+                std::destroy(first, last);
+                throw;
+            }
+        }
 
     } else {
-        std::copy(buffer.begin(), buffer.end(), std::next(this->_buffer.begin(), this->_write_ptr));
+        const auto first = std::next(storage.begin(), write_ptr);
+        std::uninitialized_copy(buffer.begin(), buffer.end(), first);
     }
 
-    this->_write_ptr = (this->_write_ptr + buffer.size()) % Capacity;
+    this->advance_write(buffer.size());
 
-    if (this->_write_ptr == this->_read_ptr) {
-        this->_is_full = true;
-    }
+    this->_stats.producer.transferred_bulk(buffer.size());
+    this->_stats.producer.occupancy(this->size());
 
     return {};
 }
 
 /*------------------------------------------------------------------------------------------------*/
 
-template<typename T, size_t Capacity>
-auto RingBuffer<T, Capacity>::pop() noexcept -> std::expected<T, Error> {
+/// @brief Move the element at the front out of the buffer.
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::pop() noexcept(
+    std::is_nothrow_move_constructible_v<T>) -> std::expected<T, Error> {
     if (this->empty()) {
+        this->_stats.consumer.failed();
         return std::unexpected{Error::Empty()};
     }
 
-    const auto value = this->_buffer[this->_read_ptr++];
-    this->_read_ptr = this->_read_ptr % Capacity;
-    this->_is_full = false;
-
-    return value;
+    return this->pop_unchecked();
 }
 
 /*------------------------------------------------------------------------------------------------*/
 
-template<typename T, size_t Capacity>
-auto RingBuffer<T, Capacity>::pop_unchecked() noexcept -> T {
-    const auto value = this->_buffer[this->_read_ptr++];
-    this->_read_ptr = this->_read_ptr % Capacity;
-    this->_is_full = false;
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::pop_unchecked() noexcept(
+    std::is_nothrow_move_constructible_v<T>) -> T {
+    auto& slot = this->_buffer[wrap(this->_read_ptr)];
+    auto value = T(std::move(slot));
+
+    std::destroy_at(std::addressof(slot));
+    this->advance_read(1);
+    this->_stats.consumer.transferred(1);
 
     return value;
 }
 
 /*------------------------------------------------------------------------------------------------*/
 
-template<typename T, size_t Capacity>
-auto RingBuffer<T, Capacity>::pop_buffer(const std::span<T> buffer) noexcept
-    -> std::expected<void, Error> {
+/// @brief Move elements from the front of the buffer into buffer.
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::pop_buffer(const std::span<T> buffer) noexcept(
+    std::is_nothrow_move_assignable_v<T>) -> std::expected<void, Error> {
     if (buffer.size() > this->size()) {
-        if (this->empty()) {
-            return std::unexpected{Error::Empty()};
-        }
+        this->_stats.consumer.failed();
         return std::unexpected{Error::Empty()};
     }
 
-    const auto items_until_wrap = Capacity - this->_read_ptr;
+    const auto read_ptr = wrap(this->_read_ptr);
+    const auto items_until_wrap = this->capacity() - read_ptr;
+    const auto storage = this->_buffer.span();
+
+    if constexpr (TrivialElement<T>) {
+        const auto live = split(storage, read_ptr, buffer.size());
+
+        copy_elements(live.first, buffer.data());
+        copy_elements(live.second, std::next(buffer.data(), live.first.size()));
 
-    if (buffer.size() > items_until_wrap) {
-        const auto chunk1 = std::span(this->_buffer).last(items_until_wrap);
-        const auto chunk2 = std::span(this->_buffer).first(buffer.size() - items_until_wrap);
+    } else if (buffer.size() > items_until_wrap) {
+        const auto chunk1 = storage.last(items_until_wrap);
+        const auto chunk2 = storage.first(buffer.size() - items_until_wrap);
 
-        std::copy(chunk1.begin(), chunk1.end(), buffer.begin());
-        std::copy(chunk2.begin(), chunk2.end(), std::next(buffer.begin(), items_until_wrap));
+        std::move(chunk1.begin(), chunk1.end(), buffer.begin());
+        std::move(chunk2.begin(), chunk2.end(), std::next(buffer.begin(), items_until_wrap));
 
     } else {
-        const auto begin = std::next(this->_buffer.begin(), this->_read_ptr);
-        const auto end = std::next(begin, items_until_wrap);
+        const auto begin = std::next(storage.begin(), read_ptr);
+        const auto end = std::next(begin, buffer.size());
+
+        std::move(begin, end, buffer.begin());
+    }
+
+    this->destroy_front(buffer.size());
+    this->advance_read(buffer.size());
+    this->_stats.consumer.transferred_bulk(buffer.size());
+
+    return {};
+}
 
-        std::copy(begin, end, buffer.begin());
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Get the next count free elements of the buffer for writing in place.
+///
+/// Data written to the returned segments is only added to the buffer by a following call to
+/// commit_write().
+///
+/// @return Segments covering count free elements. Returns Error::Full if there is less space free.
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::prepare_write(const size_t count) noexcept
+    -> std::expected<Segments<T>, Error>
+    requires TrivialElement<T>
+{
+    if (count > this->free()) {
+        this->_stats.producer.failed();
+        return std::unexpected{Error::Full()};
+    }
+
+    return split(this->_buffer.span(), wrap(this->_write_ptr), count);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Add count elements, previously written via prepare_write(), to the buffer.
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::commit_write(const size_t count) noexcept
+    -> std::expected<void, Error>
+    requires TrivialElement<T>
+{
+    if (count > this->free()) {
+        this->_stats.producer.failed();
+        return std::unexpected{Error::Full()};
+    }
+
+    this->advance_write(count);
+    this->record_push(count);
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Get the contents of the buffer without removing them.
+///
+/// The segments remain valid until the buffer is next modified.
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::peek_read() const noexcept
+    -> Segments<const T> {
+    return this->segments();
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Remove count elements from the front of the buffer without copying them out.
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::consume(const size_t count) noexcept
+    -> std::expected<void, Error> {
+    if (count > this->size()) {
+        this->_stats.consumer.failed();
+        return std::unexpected{Error::Empty()};
     }
 
-    this->_read_ptr = (this->_read_ptr + buffer.size()) % Capacity;
-    this->_is_full = false;
+    this->destroy_front(count);
+    this->advance_read(count);
+    this->_stats.consumer.transferred(count);
 
     return {};
 }
 
 /*------------------------------------------------------------------------------------------------*/
 
-template<typename T, size_t Capacity>
-auto RingBuffer<T, Capacity>::clear() noexcept -> void {
+/// @brief Call function on up to max elements from the front of the buffer, then remove them.
+///
+/// Each element is passed in place, so function may move from it. The elements are removed with a
+/// single index update once they've all been visited. If function throws, the elements visited
+/// before it are still removed.
+///
+/// @return The number of elements removed.
+template<typename T, size_t Capacity, typename StatsPolicy>
+template<typename F>
+    requires std::invocable<F&, T&>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::drain(const size_t max, F&& function) noexcept(
+    std::is_nothrow_invocable_v<F&, T&>) -> size_t {
+    const auto count = std::min(max, this->size());
+    const auto live = split(this->_buffer.span(), wrap(this->_read_ptr), count);
+
+    auto visited = size_t{0};
+    const auto visit = [&] {
+        for (auto& element : live.first) {
+            std::invoke(function, element);
+            visited++;
+        }
+
+        for (auto& element : live.second) {
+            std::invoke(function, element);
+            visited++;
+        }
+    };
+
+    if constexpr (std::is_nothrow_invocable_v<F&, T&>) {
+        visit();
+    } else {
+        try {
+            visit();
+        } catch (...) {
+            this->destroy_front(visited);
+            this->advance_read(visited);
+            this->_stats.consumer.transferred(visited);
+            throw;
+        }
+    }
+
+    this->destroy_front(count);
+    this->advance_read(count);
+    this->_stats.consumer.transferred(count);
+
+    return count;
+}
+
+/// @brief Call function on every element of the buffer, then remove them.
+///
+/// @return The number of elements removed.
+template<typename T, size_t Capacity, typename StatsPolicy>
+template<typename F>
+    requires std::invocable<F&, T&>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::drain_all(F&& function) noexcept(
+    std::is_nothrow_invocable_v<F&, T&>) -> size_t {
+    return this->drain(this->size(), std::forward<F>(function));
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Add up to max elements to the back of the buffer, each constructed from a call to
+///        generator.
+///
+/// The elements are added with a single index update once they've all been constructed. If
+/// generator or the constructor throws, the elements constructed before it are still added.
+///
+/// @return The number of elements added, which is less than max if the buffer fills up.
+template<typename T, size_t Capacity, typename StatsPolicy>
+template<typename G>
+    requires std::constructible_from<T, std::invoke_result_t<G&>>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::fill(const size_t max, G&& generator) noexcept(
+    NOTHROW_GENERATOR<G>) -> size_t {
+    const auto count = std::min(max, this->free());
+    const auto free = split(this->_buffer.span(), wrap(this->_write_ptr), count);
+
+    auto constructed = size_t{0};
+    const auto construct = [&] {
+        for (auto& slot : free.first) {
+            std::construct_at(std::addressof(slot), std::invoke(generator));
+            constructed++;
+        }
+
+        for (auto& slot : free.second) {
+            std::construct_at(std::addressof(slot), std::invoke(generator));
+            constructed++;
+        }
+    };
+
+    if constexpr (NOTHROW_GENERATOR<G>) {
+        construct();
+    } else {
+        try {
+            construct();
+        } catch (...) {
+            this->advance_write(constructed);
+            this->record_push(constructed);
+            throw;
+        }
+    }
+
+    this->advance_write(count);
+    this->record_push(count);
+
+    return count;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::clear() noexcept -> void {
+    this->destroy_front(this->size());
+
     this->_write_ptr = 0;
     this->_read_ptr = 0;
-    this->_is_full = false;
+
+    if constexpr (!FREE_RUNNING) {
+        this->_is_full = false;
+    }
 }
 
 /*------------------------------------------------------------------------------------------------*/
 
-template<typename T, size_t Capacity>
-auto RingBuffer<T, Capacity>::empty() const noexcept -> bool {
-    return this->_write_ptr == this->_read_ptr && !this->_is_full;
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::empty() const noexcept -> bool {
+    if constexpr (FREE_RUNNING) {
+        return this->_write_ptr == this->_read_ptr;
+    } else {
+        return this->_write_ptr == this->_read_ptr && !this->_is_full;
+    }
 }
 
 /*------------------------------------------------------------------------------------------------*/
 
-template<typename T, size_t Capacity>
-auto RingBuffer<T, Capacity>::full() const noexcept -> bool {
-    return this->_is_full;
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::full() const noexcept -> bool {
+    if constexpr (FREE_RUNNING) {
+        return (this->_write_ptr - this->_read_ptr) == this->capacity();
+    } else {
+        return this->_is_full;
+    }
 }
 
 /*------------------------------------------------------------------------------------------------*/
 
-template<typename T, size_t Capacity>
-auto RingBuffer<T, Capacity>::size() const noexcept -> size_t {
-    if (this->_is_full) {
-        return Capacity;
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::size() const noexcept -> size_t {
+    if constexpr (FREE_RUNNING) {
+        return this->_write_ptr - this->_read_ptr;
+    }
+
+    if (this->full()) {
+        return this->capacity();
     }
 
     if (this->_write_ptr >= this->_read_ptr) {
         return this->_write_ptr - this->_read_ptr;
     }
 
-    return this->_write_ptr + (Capacity - this->_read_ptr);
+    return this->_write_ptr + (this->capacity() - this->_read_ptr);
 }
 
 /*------------------------------------------------------------------------------------------------*/
 
-template<typename T, size_t Capacity>
-[[nodiscard]] auto RingBuffer<T, Capacity>::free() const noexcept -> size_t {
-    if (this->_is_full) {
+template<typename T, size_t Capacity, typename StatsPolicy>
+[[nodiscard]] constexpr auto RingBuffer<T, Capacity, StatsPolicy>::free() const noexcept -> size_t {
+    if constexpr (FREE_RUNNING) {
+        return this->capacity() - this->size();
+    }
+
+    if (this->full()) {
         return 0;
     }
 
     if (this->_write_ptr >= this->_read_ptr) {
-        return (Capacity - this->_write_ptr) + this->_read_ptr;
+        return (this->capacity() - this->_write_ptr) + this->_read_ptr;
     }
 
     return this->_read_ptr - this->_write_ptr;
@@ -287,9 +972,23 @@ template<typename T, size_t Capacity>
 
 /*------------------------------------------------------------------------------------------------*/
 
-template<typename T, size_t Capacity>
-auto RingBuffer<T, Capacity>::capacity() const noexcept -> size_t {
-    return Capacity;
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::capacity() const noexcept -> size_t {
+    if constexpr (DYNAMIC) {
+        return this->_buffer.size();
+    } else {
+        return Capacity;
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Get the counters recorded by the Stats policy.
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto RingBuffer<T, Capacity, StatsPolicy>::stats() const noexcept -> BufferStats
+    requires StatsPolicy::template Recorder<Sharing::None>::ENABLED
+{
+    return this->_stats.snapshot();
 }
 
 }
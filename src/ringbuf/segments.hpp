@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+namespace core::ringbuf {
+
+/// A region of a ring buffer's storage as up to two contiguous spans.
+///
+/// `first` runs from the start of the region towards the end of the storage. `second` holds
+/// whatever wrapped around to the beginning of the storage and is empty if the region doesn't wrap.
+template<typename T>
+struct Segments {
+    std::span<T> first{};
+    std::span<T> second{};
+
+    constexpr auto size() const noexcept -> size_t;
+    constexpr auto empty() const noexcept -> bool;
+};
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+constexpr auto Segments<T>::size() const noexcept -> size_t {
+    return this->first.size() + this->second.size();
+}
+
+template<typename T>
+constexpr auto Segments<T>::empty() const noexcept -> bool {
+    return this->first.empty() && this->second.empty();
+}
+
+}
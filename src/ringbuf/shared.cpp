@@ -0,0 +1,108 @@
+#if defined(__linux__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "shared.hpp"
+
+namespace {
+
+using core::ringbuf::Error;
+using core::ringbuf::shared_impl::Region;
+
+#if defined(__linux__)
+/// Map the whole of the shared memory object fd, then close it.
+auto map(const int fd, const size_t size) noexcept -> std::expected<Region, Error> {
+    auto* const base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    // The mapping keeps the memory alive.
+    close(fd);
+
+    if (base == MAP_FAILED) {
+        return std::unexpected{Error::Alloc()};
+    }
+
+    return Region{static_cast<std::byte*>(base), size};
+}
+#endif
+
+}
+
+auto core::ringbuf::shared_impl::create(const char* const name, const size_t size) noexcept
+    -> std::expected<Region, Error> {
+#if defined(__linux__)
+    const auto fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return std::unexpected{Error::Alloc()};
+    }
+
+    // A fresh object is zero filled, so the magic isn't valid until the header is written.
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return std::unexpected{Error::Alloc()};
+    }
+
+    auto region = map(fd, size);
+    if (!region) {
+        shm_unlink(name);
+    }
+
+    return region;
+#else
+    static_cast<void>(name);
+    static_cast<void>(size);
+    return std::unexpected{Error::Alloc()};
+#endif
+}
+
+auto core::ringbuf::shared_impl::attach(const char* const name) noexcept
+    -> std::expected<Region, Error> {
+#if defined(__linux__)
+    const auto fd = shm_open(name, O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return std::unexpected{Error::Alloc()};
+    }
+
+    struct stat status{};
+    if (fstat(fd, &status) != 0) {
+        close(fd);
+        return std::unexpected{Error::Alloc()};
+    }
+
+    // Created but not sized yet.
+    if (status.st_size == 0) {
+        close(fd);
+        return std::unexpected{Error::Layout()};
+    }
+
+    return map(fd, static_cast<size_t>(status.st_size));
+#else
+    static_cast<void>(name);
+    return std::unexpected{Error::Alloc()};
+#endif
+}
+
+auto core::ringbuf::shared_impl::unmap(const Region region) noexcept -> void {
+#if defined(__linux__)
+    munmap(region.base, region.size);
+#else
+    static_cast<void>(region);
+#endif
+}
+
+auto core::ringbuf::shared_impl::unlink(const char* const name) noexcept
+    -> std::expected<void, Error> {
+#if defined(__linux__)
+    if (shm_unlink(name) != 0) {
+        return std::unexpected{Error::Alloc()};
+    }
+
+    return {};
+#else
+    static_cast<void>(name);
+    return std::unexpected{Error::Alloc()};
+#endif
+}
@@ -0,0 +1,393 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "cache_line.hpp"
+#include "copy.hpp"
+#include "ringbuf.hpp"
+
+namespace core::ringbuf::shared_impl {
+
+/// Identifies a region created by SharedRingBuffer.
+inline constexpr auto MAGIC = uint32_t{0x52494E47};
+
+/// Bumped whenever the layout of Header or the data changes.
+inline constexpr auto LAYOUT_VERSION = uint32_t{2};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Indices shared between processes must be lock-free");
+
+/// State at the start of a shared region, followed by the elements.
+///
+/// Only holds integers so it means the same in every process, wherever the region is mapped. The
+/// fields before the indices are at the same offsets in every build, but where the indices and the
+/// data are depends on CACHE_LINE_SIZE, which can differ between compilers, targets and tuning. So
+/// those offsets are recorded too.
+struct Header {
+    /// Written last by the creator, so a region with a valid magic is fully initialised.
+    std::atomic<uint32_t> magic{};
+    uint32_t version{};
+    uint64_t capacity{};
+    uint64_t element_size{};
+    uint64_t element_align{};
+    uint64_t header_size{};
+    uint64_t data_offset{};
+
+    /// Free-running indices, each only written by one side.
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> write{};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> read{};
+};
+
+/// A mapped region of shared memory.
+struct Region {
+    std::byte* base{};
+    size_t size{};
+};
+
+/// Create and map the shared memory object name, which must not exist yet.
+auto create(const char* name, size_t size) noexcept -> std::expected<Region, Error>;
+
+/// Map the existing shared memory object name.
+auto attach(const char* name) noexcept -> std::expected<Region, Error>;
+
+auto unmap(Region region) noexcept -> void;
+auto unlink(const char* name) noexcept -> std::expected<void, Error>;
+
+}
+
+namespace core::ringbuf {
+
+/// Lock-free single-producer/single-consumer ring buffer in POSIX shared memory.
+///
+/// One process creates the buffer under a name and another attaches to it. The indices, capacity
+/// and a layout version live in a header at the start of the region and the elements follow it.
+/// Nothing in the shared state is a pointer, so each process may map it at a different address.
+///
+/// Like SpscRingBuffer, the producer and consumer indices are on separate cache lines and each
+/// handle caches the other side's index. One handle, in any process, may push while another pops.
+/// The capacity is rounded up to a power of two.
+///
+/// attach() fails with Error::Layout if the region wasn't created for the same element type, layout
+/// version and cache line size, or hasn't finished being created yet. Failures to create or map
+/// the region are Error::Alloc, with errno left set. Only available on Linux.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+struct SharedRingBuffer {
+    static auto create(const char* name, size_t min_capacity) noexcept
+        -> std::expected<SharedRingBuffer, Error>;
+    static auto attach(const char* name) noexcept -> std::expected<SharedRingBuffer, Error>;
+    static auto unlink(const char* name) noexcept -> std::expected<void, Error>;
+
+    SharedRingBuffer(const SharedRingBuffer& other) = delete;
+    SharedRingBuffer(SharedRingBuffer&& other) noexcept;
+    ~SharedRingBuffer() noexcept;
+
+    auto operator=(const SharedRingBuffer& other) -> SharedRingBuffer& = delete;
+    auto operator=(SharedRingBuffer&& other) noexcept -> SharedRingBuffer&;
+
+    auto push(T value) noexcept -> std::expected<void, Error>;
+    auto push_buffer(std::span<const T> buffer) noexcept -> std::expected<void, Error>;
+
+    auto pop() noexcept -> std::expected<T, Error>;
+    auto pop_buffer(std::span<T> buffer) noexcept -> std::expected<void, Error>;
+
+    auto empty() const noexcept -> bool;
+    auto full() const noexcept -> bool;
+
+    auto size() const noexcept -> size_t;
+    auto free() const noexcept -> size_t;
+    auto capacity() const noexcept -> size_t;
+
+private:
+    /// Offset of the elements from the start of the region.
+    static constexpr auto DATA_OFFSET =
+        (sizeof(shared_impl::Header) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+    explicit SharedRingBuffer(shared_impl::Region region) noexcept;
+
+    auto header() const noexcept -> shared_impl::Header&;
+    auto slot(uint64_t index) const noexcept -> T*;
+
+    shared_impl::Region _region{};
+    T* _data{};
+    uint64_t _mask{};
+
+    /// This handle's copies of the indices last seen from the other side.
+    uint64_t _cached_read{};
+    uint64_t _cached_write{};
+};
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+SharedRingBuffer<T>::SharedRingBuffer(const shared_impl::Region region) noexcept :
+    _region{region},
+    _data{reinterpret_cast<T*>(region.base + DATA_OFFSET)},
+    _mask{this->header().capacity - 1},
+    _cached_read{this->header().read.load(std::memory_order_acquire)},
+    _cached_write{this->header().write.load(std::memory_order_acquire)} {}
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+SharedRingBuffer<T>::SharedRingBuffer(SharedRingBuffer&& other) noexcept :
+    _region{std::exchange(other._region, {})},
+    _data{std::exchange(other._data, nullptr)},
+    _mask{other._mask},
+    _cached_read{other._cached_read},
+    _cached_write{other._cached_write} {}
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+SharedRingBuffer<T>::~SharedRingBuffer() noexcept {
+    if (this->_region.base != nullptr) {
+        shared_impl::unmap(this->_region);
+    }
+}
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::operator=(SharedRingBuffer&& other) noexcept -> SharedRingBuffer& {
+    std::swap(this->_region, other._region);
+    std::swap(this->_data, other._data);
+    std::swap(this->_mask, other._mask);
+    std::swap(this->_cached_read, other._cached_read);
+    std::swap(this->_cached_write, other._cached_write);
+
+    return *this;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Create the shared memory object name holding a buffer of at least min_capacity elements.
+///
+/// @return The buffer, or Error::Alloc if the object already exists, couldn't be created, or
+///         min_capacity elements wouldn't fit in the address space.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::create(const char* const name, const size_t min_capacity) noexcept
+    -> std::expected<SharedRingBuffer, Error> {
+    // Largest power of two capacity whose region size can be computed without wrapping, so that
+    // bit_ceil() below can always represent its result.
+    constexpr auto MAX_CAPACITY =
+        std::bit_floor((std::numeric_limits<size_t>::max() - DATA_OFFSET) / sizeof(T));
+
+    if (min_capacity > MAX_CAPACITY) {
+        return std::unexpected{Error::Alloc()};
+    }
+
+    const auto capacity = std::bit_ceil(std::max(min_capacity, size_t{1}));
+
+    const auto region = shared_impl::create(name, DATA_OFFSET + (capacity * sizeof(T)));
+    if (!region) {
+        return std::unexpected{region.error()};
+    }
+
+    auto* const header = std::construct_at(reinterpret_cast<shared_impl::Header*>(region->base));
+    header->version = shared_impl::LAYOUT_VERSION;
+    header->capacity = capacity;
+    header->element_size = sizeof(T);
+    header->element_align = alignof(T);
+    header->header_size = sizeof(shared_impl::Header);
+    header->data_offset = DATA_OFFSET;
+    header->magic.store(shared_impl::MAGIC, std::memory_order_release);
+
+    return SharedRingBuffer(*region);
+}
+
+/// @brief Attach to the buffer in the shared memory object name.
+///
+/// @return The buffer, Error::Alloc if the object couldn't be mapped, or Error::Layout if it
+///         doesn't hold a fully created buffer of T with the same layout version and header
+///         layout.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::attach(const char* const name) noexcept
+    -> std::expected<SharedRingBuffer, Error> {
+    const auto region = shared_impl::attach(name);
+    if (!region) {
+        return std::unexpected{region.error()};
+    }
+
+    if (region->size < sizeof(shared_impl::Header)) {
+        shared_impl::unmap(*region);
+        return std::unexpected{Error::Layout()};
+    }
+
+    const auto& header = *std::launder(reinterpret_cast<shared_impl::Header*>(region->base));
+
+    const auto valid = header.magic.load(std::memory_order_acquire) == shared_impl::MAGIC
+                       && header.version == shared_impl::LAYOUT_VERSION
+                       && header.element_size == sizeof(T) && header.element_align == alignof(T)
+                       && header.header_size == sizeof(shared_impl::Header)
+                       && header.data_offset == DATA_OFFSET
+                       && std::has_single_bit(header.capacity) && region->size >= DATA_OFFSET
+                       && header.capacity <= (region->size - DATA_OFFSET) / sizeof(T);
+
+    if (!valid) {
+        shared_impl::unmap(*region);
+        return std::unexpected{Error::Layout()};
+    }
+
+    return SharedRingBuffer(*region);
+}
+
+/// @brief Remove the name of a shared memory object.
+///
+/// Handles which are already attached keep working, and the memory is freed once they're all gone.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::unlink(const char* const name) noexcept -> std::expected<void, Error> {
+    return shared_impl::unlink(name);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::header() const noexcept -> shared_impl::Header& {
+    return *std::launder(reinterpret_cast<shared_impl::Header*>(this->_region.base));
+}
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::slot(const uint64_t index) const noexcept -> T* {
+    return std::next(this->_data, static_cast<std::ptrdiff_t>(index & this->_mask));
+}
+
+////////////////////////////////////////////////////////////////
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::push(const T value) noexcept -> std::expected<void, Error> {
+    return this->push_buffer(std::span{&value, 1});
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Write all of buffer, or none of it if there isn't space.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::push_buffer(const std::span<const T> buffer) noexcept
+    -> std::expected<void, Error> {
+    auto& header = this->header();
+    const auto write = header.write.load(std::memory_order_relaxed);
+
+    if (buffer.size() > this->capacity() - (write - this->_cached_read)) {
+        this->_cached_read = header.read.load(std::memory_order_acquire);
+
+        if (buffer.size() > this->capacity() - (write - this->_cached_read)) {
+            return std::unexpected{Error::Full()};
+        }
+    }
+
+    const auto until_wrap = static_cast<size_t>(this->capacity() - (write & this->_mask));
+    const auto first = std::min(buffer.size(), until_wrap);
+
+    copy_elements(buffer.first(first), this->slot(write));
+    copy_elements(buffer.subspan(first), this->_data);
+
+    header.write.store(write + buffer.size(), std::memory_order_release);
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::pop() noexcept -> std::expected<T, Error> {
+    auto value = T{};
+
+    if (auto result = this->pop_buffer(std::span{&value, 1}); !result) {
+        return std::unexpected{result.error()};
+    }
+
+    return value;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Fill buffer with the oldest elements, or take none of them if there aren't enough.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::pop_buffer(const std::span<T> buffer) noexcept
+    -> std::expected<void, Error> {
+    auto& header = this->header();
+    const auto read = header.read.load(std::memory_order_relaxed);
+
+    if (buffer.size() > this->_cached_write - read) {
+        this->_cached_write = header.write.load(std::memory_order_acquire);
+
+        if (buffer.size() > this->_cached_write - read) {
+            return std::unexpected{Error::Empty()};
+        }
+    }
+
+    const auto until_wrap = static_cast<size_t>(this->capacity() - (read & this->_mask));
+    const auto first = std::min(buffer.size(), until_wrap);
+
+    const auto rest = buffer.size() - first;
+
+    copy_elements<T>(std::span{this->slot(read), first}, buffer.data());
+    copy_elements<T>(std::span{this->_data, rest}, std::next(buffer.data(), first));
+
+    header.read.store(read + buffer.size(), std::memory_order_release);
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::empty() const noexcept -> bool {
+    return this->size() == 0;
+}
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::full() const noexcept -> bool {
+    return this->size() == this->capacity();
+}
+
+/// @brief Get the number of elements in the buffer.
+///
+/// Only a snapshot while the other side is active.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::size() const noexcept -> size_t {
+    // Reading the consumer's index first means the producer's can't be behind it.
+    const auto read = this->header().read.load(std::memory_order_acquire);
+    const auto write = this->header().write.load(std::memory_order_acquire);
+
+    return static_cast<size_t>(write - read);
+}
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::free() const noexcept -> size_t {
+    return this->capacity() - this->size();
+}
+
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+auto SharedRingBuffer<T>::capacity() const noexcept -> size_t {
+    return static_cast<size_t>(this->_mask + 1);
+}
+
+}
@@ -0,0 +1,517 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <stop_token>
+#include <utility>
+
+#include "async.hpp"
+#include "cache_line.hpp"
+#include "copy.hpp"
+#include "ringbuf.hpp"
+#include "stats.hpp"
+#include "wait.hpp"
+
+namespace core::ringbuf {
+
+/// Lock-free single-producer/single-consumer ring buffer.
+///
+/// One thread may call the push functions while another calls the pop functions, without any
+/// external locking. The read and write indices run over [0, 2 * Capacity) so a full buffer can be
+/// told apart from an empty one without a shared flag. Each index is only ever written by one side
+/// and published with release ordering.
+///
+/// The producer and consumer state live on separate cache lines. Each side also keeps a cached
+/// copy of the other side's index and only reloads it when the buffer looks full (producer) or
+/// empty (consumer), so in the common case neither side touches the other's cache line.
+///
+/// push_wait() and pop_wait() block until there's space or data, spinning briefly and then parking
+/// the thread. Each side only makes the wake-up syscall when the other side is actually parked.
+///
+/// async_push() and async_pop() are the coroutine equivalents. They suspend the coroutine instead
+/// of blocking, and it's resumed on the other side's thread, inside the push or pop that let it
+/// proceed. close() fails any waiting or future waits with Error::Closed, although pops still
+/// drain whatever's left first. The non-waiting functions aren't affected by close().
+///
+/// size(), free(), empty() and full() are exact when called from the producer or consumer thread,
+/// but only a snapshot when the other side is active.
+///
+/// With StatsPolicy set to Stats each side counts its own transfers and failures on its own cache
+/// line. Only push(), push_buffer(), pop() and pop_buffer() count failures, so retries while
+/// waiting don't. The high-water mark is sampled when the consumer reloads the producer's index,
+/// and when a push finds the buffer full, so it may miss short peaks.
+template<typename T, size_t Capacity, typename StatsPolicy = NoStats>
+struct SpscRingBuffer {
+    static_assert(Capacity > 0);
+
+    auto push(T value) noexcept -> std::expected<void, Error>;
+    auto push_buffer(std::span<const T> buffer) noexcept -> std::expected<void, Error>;
+
+    auto pop() noexcept -> std::expected<T, Error>;
+    auto pop_buffer(std::span<T> buffer) noexcept -> std::expected<void, Error>;
+
+    auto push_wait(T value) noexcept -> std::expected<void, Error>;
+    auto push_wait_for(T value, std::chrono::nanoseconds timeout) noexcept
+        -> std::expected<void, Error>;
+
+    auto pop_wait() noexcept -> std::expected<T, Error>;
+    auto pop_wait_for(std::chrono::nanoseconds timeout) noexcept -> std::expected<T, Error>;
+
+    auto async_push(T value, std::stop_token token = {}) noexcept
+        -> PushAwaitable<SpscRingBuffer, T>;
+    auto async_pop(std::stop_token token = {}) noexcept -> PopAwaitable<SpscRingBuffer, T>;
+
+    auto close() noexcept -> void;
+    auto closed() const noexcept -> bool;
+
+    auto empty() const noexcept -> bool;
+    auto full() const noexcept -> bool;
+
+    auto size() const noexcept -> size_t;
+    auto free() const noexcept -> size_t;
+    auto capacity() const noexcept -> size_t;
+
+    auto stats() const noexcept -> BufferStats
+        requires StatsPolicy::template Recorder<Sharing::Single>::ENABLED;
+
+private:
+    friend struct PushAwaitable<SpscRingBuffer, T>;
+    friend struct PopAwaitable<SpscRingBuffer, T>;
+
+    static constexpr auto advance(size_t index, size_t count) noexcept -> size_t;
+    static constexpr auto distance(size_t write, size_t read) noexcept -> size_t;
+    static constexpr auto slot(size_t index) noexcept -> size_t;
+
+    auto put(const T& value) noexcept -> std::expected<void, Error>;
+    auto take() noexcept -> std::expected<T, Error>;
+
+    auto attempt_push(const T& value) noexcept -> std::expected<void, Error>;
+    auto attempt_pop() noexcept -> std::expected<T, Error>;
+
+    auto wake_producers() noexcept -> void;
+    auto wake_consumers() noexcept -> void;
+
+    auto push_until(T value, Deadline deadline) noexcept -> std::expected<void, Error>;
+    auto pop_until(Deadline deadline) noexcept -> std::expected<T, Error>;
+
+    /// State written by the producer.
+    struct alignas(CACHE_LINE_SIZE) Producer {
+        std::atomic<size_t> write_ptr{};
+        size_t cached_read_ptr{};
+    };
+
+    /// State written by the consumer.
+    struct alignas(CACHE_LINE_SIZE) Consumer {
+        std::atomic<size_t> read_ptr{};
+        size_t cached_write_ptr{};
+    };
+
+    Producer _producer{};
+    Consumer _consumer{};
+
+    [[no_unique_address]] StatsPolicy::template Recorder<Sharing::Single> _stats{};
+
+    /// The producer waiting for space and the consumer waiting for data.
+    alignas(CACHE_LINE_SIZE) WaitQueue _producer_waiters{};
+    alignas(CACHE_LINE_SIZE) WaitQueue _consumer_waiters{};
+    std::atomic<bool> _closed{};
+
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> _buffer{};
+};
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto SpscRingBuffer<T, Capacity, StatsPolicy>::advance(const size_t index,
+                                                              const size_t count) noexcept
+    -> size_t {
+    const auto next = index + count;
+    return next >= (2 * Capacity) ? next - (2 * Capacity) : next;
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto SpscRingBuffer<T, Capacity, StatsPolicy>::distance(const size_t write,
+                                                               const size_t read) noexcept
+    -> size_t {
+    return write >= read ? write - read : write + (2 * Capacity) - read;
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+constexpr auto SpscRingBuffer<T, Capacity, StatsPolicy>::slot(const size_t index) noexcept
+    -> size_t {
+    return index >= Capacity ? index - Capacity : index;
+}
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::push(const T value) noexcept
+    -> std::expected<void, Error> {
+    auto result = this->put(value);
+
+    if (result) {
+        this->wake_consumers();
+    } else {
+        this->_stats.producer.failed();
+        this->_stats.producer.occupancy(Capacity);
+    }
+
+    return result;
+}
+
+/// Push value without notifying any waiting consumers.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::put(const T& value) noexcept
+    -> std::expected<void, Error> {
+    const auto write = this->_producer.write_ptr.load(std::memory_order_relaxed);
+
+    if (distance(write, this->_producer.cached_read_ptr) == Capacity) {
+        this->_producer.cached_read_ptr = this->_consumer.read_ptr.load(std::memory_order_acquire);
+
+        if (distance(write, this->_producer.cached_read_ptr) == Capacity) {
+            return std::unexpected{Error::Full()};
+        }
+    }
+
+    this->_buffer[slot(write)] = value;
+    this->_producer.write_ptr.store(advance(write, 1), std::memory_order_release);
+    this->_stats.producer.transferred(1);
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::push_buffer(const std::span<const T> buffer) noexcept
+    -> std::expected<void, Error> {
+    const auto write = this->_producer.write_ptr.load(std::memory_order_relaxed);
+
+    if (buffer.size() > (Capacity - distance(write, this->_producer.cached_read_ptr))) {
+        this->_producer.cached_read_ptr = this->_consumer.read_ptr.load(std::memory_order_acquire);
+
+        if (buffer.size() > (Capacity - distance(write, this->_producer.cached_read_ptr))) {
+            this->_stats.producer.failed();
+            return std::unexpected{Error::Full()};
+        }
+    }
+
+    const auto write_slot = slot(write);
+    const auto space_until_wrap = Capacity - write_slot;
+
+    if (buffer.size() > space_until_wrap) {
+        const auto chunk1 = buffer.first(space_until_wrap);
+        const auto chunk2 = buffer.last(buffer.size() - space_until_wrap);
+
+        copy_elements(chunk1, std::next(this->_buffer.data(), write_slot));
+        copy_elements(chunk2, this->_buffer.data());
+
+    } else {
+        copy_elements(buffer, std::next(this->_buffer.data(), write_slot));
+    }
+
+    this->_producer.write_ptr.store(advance(write, buffer.size()), std::memory_order_release);
+    this->_stats.producer.transferred_bulk(buffer.size());
+    this->wake_consumers();
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::pop() noexcept -> std::expected<T, Error> {
+    auto result = this->take();
+
+    if (result) {
+        this->wake_producers();
+    } else {
+        this->_stats.consumer.failed();
+    }
+
+    return result;
+}
+
+/// Pop an element without notifying any waiting producers.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::take() noexcept -> std::expected<T, Error> {
+    const auto read = this->_consumer.read_ptr.load(std::memory_order_relaxed);
+
+    if (read == this->_consumer.cached_write_ptr) {
+        this->_consumer.cached_write_ptr =
+            this->_producer.write_ptr.load(std::memory_order_acquire);
+        this->_stats.consumer.occupancy(distance(this->_consumer.cached_write_ptr, read));
+
+        if (read == this->_consumer.cached_write_ptr) {
+            return std::unexpected{Error::Empty()};
+        }
+    }
+
+    const auto value = this->_buffer[slot(read)];
+    this->_consumer.read_ptr.store(advance(read, 1), std::memory_order_release);
+    this->_stats.consumer.transferred(1);
+
+    return value;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::pop_buffer(const std::span<T> buffer) noexcept
+    -> std::expected<void, Error> {
+    const auto read = this->_consumer.read_ptr.load(std::memory_order_relaxed);
+
+    if (buffer.size() > distance(this->_consumer.cached_write_ptr, read)) {
+        this->_consumer.cached_write_ptr =
+            this->_producer.write_ptr.load(std::memory_order_acquire);
+        this->_stats.consumer.occupancy(distance(this->_consumer.cached_write_ptr, read));
+
+        if (buffer.size() > distance(this->_consumer.cached_write_ptr, read)) {
+            this->_stats.consumer.failed();
+            return std::unexpected{Error::Empty()};
+        }
+    }
+
+    const auto read_slot = slot(read);
+    const auto items_until_wrap = Capacity - read_slot;
+
+    if (buffer.size() > items_until_wrap) {
+        const auto chunk1 = std::span(this->_buffer).last(items_until_wrap);
+        const auto chunk2 = std::span(this->_buffer).first(buffer.size() - items_until_wrap);
+
+        copy_elements(chunk1, buffer.data());
+        copy_elements(chunk2, std::next(buffer.data(), items_until_wrap));
+
+    } else {
+        copy_elements(std::span(this->_buffer).subspan(read_slot, buffer.size()), buffer.data());
+    }
+
+    this->_consumer.read_ptr.store(advance(read, buffer.size()), std::memory_order_release);
+    this->_stats.consumer.transferred_bulk(buffer.size());
+    this->wake_producers();
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// Push value unless the buffer is closed, without notifying any waiting consumers.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::attempt_push(const T& value) noexcept
+    -> std::expected<void, Error> {
+    if (this->closed()) {
+        return std::unexpected{Error::Closed()};
+    }
+
+    return this->put(value);
+}
+
+/// Pop an element, or fail with Error::Closed if the buffer is empty and closed.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::attempt_pop() noexcept -> std::expected<T, Error> {
+    auto result = this->take();
+
+    if (!result && this->closed()) {
+        return std::unexpected{Error::Closed()};
+    }
+
+    return result;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// Wake the producers, and keep alternating between the two sides for as long as completing a
+/// suspended coroutine's operation lets the other side make progress.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::wake_producers() noexcept -> void {
+    while (this->_producer_waiters.notify() && this->_consumer_waiters.notify()) {}
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::wake_consumers() noexcept -> void {
+    while (this->_consumer_waiters.notify() && this->_producer_waiters.notify()) {}
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::push_until(const T value,
+                                                        const Deadline deadline) noexcept
+    -> std::expected<void, Error> {
+    auto result = this->attempt_push(value);
+
+    if (!result && result.error() == Error::Full()) {
+        this->_producer_waiters.wait_until(
+            [&] {
+                result = this->attempt_push(value);
+                return result || result.error() != Error::Full();
+            },
+            deadline);
+    }
+
+    if (result) {
+        this->wake_consumers();
+    }
+
+    return result;
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::pop_until(const Deadline deadline) noexcept
+    -> std::expected<T, Error> {
+    auto result = this->attempt_pop();
+
+    if (!result && result.error() == Error::Empty()) {
+        this->_consumer_waiters.wait_until(
+            [&] {
+                result = this->attempt_pop();
+                return result || result.error() != Error::Empty();
+            },
+            deadline);
+    }
+
+    if (result) {
+        this->wake_producers();
+    }
+
+    return result;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Push value, blocking until there's space for it.
+///
+/// @return Error::Closed if the buffer was closed first.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::push_wait(const T value) noexcept
+    -> std::expected<void, Error> {
+    return this->push_until(value, std::nullopt);
+}
+
+/// @brief Push value, blocking for up to timeout until there's space for it.
+///
+/// @return Error::Full if the timeout expired first, or Error::Closed if the buffer was closed.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::push_wait_for(
+    const T value, const std::chrono::nanoseconds timeout) noexcept
+    -> std::expected<void, Error> {
+    return this->push_until(value, std::chrono::steady_clock::now() + timeout);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Pop an element, blocking until one is available.
+///
+/// @return Error::Closed if the buffer is empty and was closed.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::pop_wait() noexcept -> std::expected<T, Error> {
+    return this->pop_until(std::nullopt);
+}
+
+/// @brief Pop an element, blocking for up to timeout until one is available.
+///
+/// @return Error::Empty if the timeout expired first, or Error::Closed if the buffer is empty and
+///         was closed.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::pop_wait_for(
+    const std::chrono::nanoseconds timeout) noexcept -> std::expected<T, Error> {
+    return this->pop_until(std::chrono::steady_clock::now() + timeout);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Push value, suspending the calling coroutine until there's space for it.
+///
+/// @return An awaitable which yields Error::Closed if the buffer was closed, or Error::Cancelled
+///         if a stop was requested on token.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::async_push(T value, std::stop_token token) noexcept
+    -> PushAwaitable<SpscRingBuffer, T> {
+    return {*this, std::move(value), std::move(token)};
+}
+
+/// @brief Pop an element, suspending the calling coroutine until one is available.
+///
+/// @return An awaitable which yields Error::Closed if the buffer is empty and was closed, or
+///         Error::Cancelled if a stop was requested on token.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::async_pop(std::stop_token token) noexcept
+    -> PopAwaitable<SpscRingBuffer, T> {
+    return {*this, std::move(token)};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Close the buffer, failing every waiting push and any pop which finds it empty.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::close() noexcept -> void {
+    this->_closed.store(true, std::memory_order_release);
+
+    this->wake_producers();
+    this->wake_consumers();
+}
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::closed() const noexcept -> bool {
+    return this->_closed.load(std::memory_order_acquire);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::empty() const noexcept -> bool {
+    return this->size() == 0;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::full() const noexcept -> bool {
+    return this->size() == Capacity;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::size() const noexcept -> size_t {
+    const auto read = this->_consumer.read_ptr.load(std::memory_order_acquire);
+    const auto write = this->_producer.write_ptr.load(std::memory_order_acquire);
+
+    return distance(write, read);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::free() const noexcept -> size_t {
+    return Capacity - this->size();
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::capacity() const noexcept -> size_t {
+    return Capacity;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Get the counters recorded by the Stats policy.
+///
+/// May be called from any thread.
+template<typename T, size_t Capacity, typename StatsPolicy>
+auto SpscRingBuffer<T, Capacity, StatsPolicy>::stats() const noexcept -> BufferStats
+    requires StatsPolicy::template Recorder<Sharing::Single>::ENABLED
+{
+    return this->_stats.snapshot();
+}
+
+}
+
+/*------------------------------------------------------------------------------------------------*/
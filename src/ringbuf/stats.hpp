@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "cache_line.hpp"
+
+namespace core::ringbuf {
+
+/// Number of buckets in the bulk transfer histograms.
+///
+/// Bucket 0 counts empty transfers and bucket i counts transfers of [2^(i - 1), 2^i) elements. The
+/// last bucket also counts anything larger.
+inline constexpr auto BULK_BUCKETS = size_t{16};
+
+/// Counters for one side of a buffer.
+struct SideStats {
+    /// Elements pushed by the producer side, or popped by the consumer side.
+    uint64_t elements{};
+
+    /// Operations which failed with Error::Full on the producer side, or Error::Empty on the
+    /// consumer side.
+    uint64_t failures{};
+
+    /// Sizes of the push_buffer() or pop_buffer() calls which succeeded.
+    std::array<uint64_t, BULK_BUCKETS> bulk{};
+};
+
+/// Snapshot of the counters recorded by a buffer using the Stats policy.
+struct BufferStats {
+    SideStats producer{};
+    SideStats consumer{};
+
+    /// The most elements the buffer has been seen to hold.
+    size_t high_water{};
+};
+
+/// How the counters of one side are shared between threads.
+enum class Sharing {
+    /// The buffer isn't thread-safe, so neither are its counters.
+    None,
+
+    /// One thread writes each side's counters, while others may read them.
+    Single,
+
+    /// Several threads may write each side's counters.
+    Multi,
+};
+
+namespace stats_impl {
+
+template<Sharing SHARING>
+using Counter = std::conditional_t<SHARING == Sharing::None, uint64_t, std::atomic<uint64_t>>;
+
+template<Sharing SHARING>
+constexpr auto add(Counter<SHARING>& counter, uint64_t value) noexcept -> void;
+
+template<Sharing SHARING>
+constexpr auto load(const Counter<SHARING>& counter) noexcept -> uint64_t;
+
+}
+
+/// Stats policy which records nothing.
+///
+/// Its recorder is empty and every hook does nothing, so a buffer using it compiles to the same
+/// code as one without stats.
+struct NoStats {
+    template<Sharing SHARING>
+    struct Recorder {
+        static constexpr auto ENABLED = false;
+
+        struct Side {
+            static constexpr auto transferred(size_t /*unused*/) noexcept -> void {}
+            static constexpr auto transferred_bulk(size_t /*unused*/) noexcept -> void {}
+            static constexpr auto failed() noexcept -> void {}
+            static constexpr auto occupancy(size_t /*unused*/) noexcept -> void {}
+        };
+
+        static constexpr auto producer = Side{};
+        static constexpr auto consumer = Side{};
+    };
+};
+
+/// Stats policy which records how much each side transferred, how often it failed, the sizes of
+/// its bulk transfers and the buffer's high-water mark.
+///
+/// Each side's counters are only written by that side. For concurrent buffers they also sit on
+/// their own cache line, so recording them adds no traffic between the producer and consumer
+/// cores. With a single thread per side the counters are updated with relaxed loads and stores
+/// rather than atomic read-modify-writes, so they cost about as much as a plain increment.
+struct Stats {
+    template<Sharing SHARING>
+    struct Recorder {
+        static constexpr auto ENABLED = true;
+
+        struct alignas(SHARING == Sharing::None ? alignof(uint64_t) : CACHE_LINE_SIZE) Side {
+            constexpr auto transferred(size_t count) noexcept -> void;
+            constexpr auto transferred_bulk(size_t count) noexcept -> void;
+            constexpr auto failed() noexcept -> void;
+            constexpr auto occupancy(size_t size) noexcept -> void;
+
+            constexpr auto snapshot() const noexcept -> SideStats;
+
+            stats_impl::Counter<SHARING> elements{};
+            stats_impl::Counter<SHARING> failures{};
+            std::array<stats_impl::Counter<SHARING>, BULK_BUCKETS> bulk{};
+            stats_impl::Counter<SHARING> high_water{};
+        };
+
+        constexpr auto snapshot() const noexcept -> BufferStats;
+
+        Side producer{};
+        Side consumer{};
+    };
+};
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+template<Sharing SHARING>
+constexpr auto stats_impl::add(Counter<SHARING>& counter, const uint64_t value) noexcept -> void {
+    if constexpr (SHARING == Sharing::None) {
+        counter += value;
+    } else if constexpr (SHARING == Sharing::Single) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    } else {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+}
+
+template<Sharing SHARING>
+constexpr auto stats_impl::load(const Counter<SHARING>& counter) noexcept -> uint64_t {
+    if constexpr (SHARING == Sharing::None) {
+        return counter;
+    } else {
+        return counter.load(std::memory_order_relaxed);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<Sharing SHARING>
+constexpr auto Stats::Recorder<SHARING>::Side::transferred(const size_t count) noexcept -> void {
+    stats_impl::add<SHARING>(this->elements, count);
+}
+
+/// Record a push_buffer() or pop_buffer() of count elements.
+template<Sharing SHARING>
+constexpr auto Stats::Recorder<SHARING>::Side::transferred_bulk(const size_t count) noexcept
+    -> void {
+    const auto bucket = std::min(static_cast<size_t>(std::bit_width(count)), BULK_BUCKETS - 1);
+
+    stats_impl::add<SHARING>(this->elements, count);
+    stats_impl::add<SHARING>(this->bulk[bucket], 1);
+}
+
+template<Sharing SHARING>
+constexpr auto Stats::Recorder<SHARING>::Side::failed() noexcept -> void {
+    stats_impl::add<SHARING>(this->failures, 1);
+}
+
+/// Record that the buffer was seen holding size elements.
+template<Sharing SHARING>
+constexpr auto Stats::Recorder<SHARING>::Side::occupancy(const size_t size) noexcept -> void {
+    if constexpr (SHARING == Sharing::None) {
+        this->high_water = std::max<uint64_t>(this->high_water, size);
+    } else {
+        // Only written once the mark is exceeded, so this is a load in the steady state.
+        auto high_water = this->high_water.load(std::memory_order_relaxed);
+
+        while (size > high_water && !this->high_water.compare_exchange_weak(
+                                        high_water, size, std::memory_order_relaxed)) {}
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<Sharing SHARING>
+constexpr auto Stats::Recorder<SHARING>::Side::snapshot() const noexcept -> SideStats {
+    auto stats = SideStats{};
+
+    stats.elements = stats_impl::load<SHARING>(this->elements);
+    stats.failures = stats_impl::load<SHARING>(this->failures);
+
+    for (auto i = size_t{0}; i < BULK_BUCKETS; i++) {
+        stats.bulk[i] = stats_impl::load<SHARING>(this->bulk[i]);
+    }
+
+    return stats;
+}
+
+/// @brief Read the counters of both sides.
+///
+/// While the buffer is in use each counter is read individually, so they may not all be from the
+/// same instant.
+template<Sharing SHARING>
+constexpr auto Stats::Recorder<SHARING>::snapshot() const noexcept -> BufferStats {
+    const auto high_water = std::max(stats_impl::load<SHARING>(this->producer.high_water),
+                                     stats_impl::load<SHARING>(this->consumer.high_water));
+
+    return {this->producer.snapshot(), this->consumer.snapshot(), static_cast<size_t>(high_water)};
+}
+
+}
+
+/*------------------------------------------------------------------------------------------------*/
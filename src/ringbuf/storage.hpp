@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace core::ringbuf {
+
+/// Element types whose storage slots can be treated as always alive.
+template<typename T>
+concept TrivialElement =
+    std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>;
+
+/// Element storage for RingBuffer.
+///
+/// A fixed Capacity is stored inline. std::dynamic_extent allocates the storage from a
+/// std::pmr::memory_resource at runtime instead.
+///
+/// Slots for a TrivialElement are always alive and can be written directly. Slots for any other
+/// type are left uninitialised and the owner is responsible for constructing and destroying the
+/// elements in them.
+template<typename T, size_t Capacity>
+struct Storage {
+    constexpr Storage() noexcept
+        requires TrivialElement<T>
+        : _data{} {}
+    constexpr Storage() noexcept {}
+
+    constexpr ~Storage() noexcept
+        requires std::is_trivially_destructible_v<T>
+    = default;
+    constexpr ~Storage() noexcept {}
+
+    constexpr auto operator[](size_t index) noexcept -> T&;
+    constexpr auto operator[](size_t index) const noexcept -> const T&;
+
+    constexpr auto span() noexcept -> std::span<T, Capacity>;
+    constexpr auto span() const noexcept -> std::span<const T, Capacity>;
+
+    constexpr auto size() const noexcept -> size_t;
+
+private:
+    union {
+        T _data[Capacity];
+    };
+};
+
+/// Runtime sized storage allocated from a std::pmr::memory_resource.
+///
+/// The memory is allocated but no elements are constructed in it. A moved-from Storage has a size
+/// of 0.
+template<typename T>
+struct Storage<T, std::dynamic_extent> {
+    Storage() noexcept = default;
+    Storage(size_t size, std::pmr::memory_resource* resource);
+
+    Storage(const Storage& other) = delete;
+    Storage(Storage&& other) noexcept;
+    ~Storage() noexcept;
+
+    auto operator=(const Storage& other) -> Storage& = delete;
+    auto operator=(Storage&& other) noexcept -> Storage&;
+
+    auto operator[](size_t index) noexcept -> T&;
+    auto operator[](size_t index) const noexcept -> const T&;
+
+    auto span() noexcept -> std::span<T>;
+    auto span() const noexcept -> std::span<const T>;
+
+    auto size() const noexcept -> size_t;
+    auto resource() const noexcept -> std::pmr::memory_resource*;
+
+private:
+    static auto bytes(size_t size) -> size_t;
+
+    std::pmr::memory_resource* _resource{};
+    T* _data{};
+    size_t _size{};
+};
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity>
+constexpr auto Storage<T, Capacity>::operator[](const size_t index) noexcept -> T& {
+    return this->_data[index];
+}
+
+template<typename T, size_t Capacity>
+constexpr auto Storage<T, Capacity>::operator[](const size_t index) const noexcept -> const T& {
+    return this->_data[index];
+}
+
+template<typename T, size_t Capacity>
+constexpr auto Storage<T, Capacity>::span() noexcept -> std::span<T, Capacity> {
+    return std::span{this->_data};
+}
+
+template<typename T, size_t Capacity>
+constexpr auto Storage<T, Capacity>::span() const noexcept -> std::span<const T, Capacity> {
+    return std::span{this->_data};
+}
+
+template<typename T, size_t Capacity>
+constexpr auto Storage<T, Capacity>::size() const noexcept -> size_t {
+    return Capacity;
+}
+
+////////////////////////////////////////////////////////////////
+
+/// @brief Allocate space for size elements from resource.
+///
+/// Throws std::bad_alloc if the allocation fails, or std::bad_array_new_length if the size in
+/// bytes doesn't fit in a size_t.
+template<typename T>
+Storage<T, std::dynamic_extent>::Storage(const size_t size,
+                                         std::pmr::memory_resource* const resource) :
+    _resource{resource},
+    _data{static_cast<T*>(resource->allocate(bytes(size), alignof(T)))},
+    _size{size} {}
+
+/// Size in bytes of size elements, checked so that a huge size can't wrap to a small allocation.
+template<typename T>
+auto Storage<T, std::dynamic_extent>::bytes(const size_t size) -> size_t {
+    if (size > std::numeric_limits<size_t>::max() / sizeof(T)) {
+        throw std::bad_array_new_length{};
+    }
+
+    return size * sizeof(T);
+}
+
+template<typename T>
+Storage<T, std::dynamic_extent>::Storage(Storage&& other) noexcept :
+    _resource{std::exchange(other._resource, nullptr)},
+    _data{std::exchange(other._data, nullptr)},
+    _size{std::exchange(other._size, 0)} {}
+
+template<typename T>
+Storage<T, std::dynamic_extent>::~Storage() noexcept {
+    if (this->_data != nullptr) {
+        this->_resource->deallocate(this->_data, this->_size * sizeof(T), alignof(T));
+    }
+}
+
+template<typename T>
+auto Storage<T, std::dynamic_extent>::operator=(Storage&& other) noexcept -> Storage& {
+    std::swap(this->_resource, other._resource);
+    std::swap(this->_data, other._data);
+    std::swap(this->_size, other._size);
+
+    return *this;
+}
+
+template<typename T>
+auto Storage<T, std::dynamic_extent>::operator[](const size_t index) noexcept -> T& {
+    return this->_data[index];
+}
+
+template<typename T>
+auto Storage<T, std::dynamic_extent>::operator[](const size_t index) const noexcept -> const T& {
+    return this->_data[index];
+}
+
+template<typename T>
+auto Storage<T, std::dynamic_extent>::span() noexcept -> std::span<T> {
+    return std::span{this->_data, this->_size};
+}
+
+template<typename T>
+auto Storage<T, std::dynamic_extent>::span() const noexcept -> std::span<const T> {
+    return std::span<const T>{this->_data, this->_size};
+}
+
+template<typename T>
+auto Storage<T, std::dynamic_extent>::size() const noexcept -> size_t {
+    return this->_size;
+}
+
+template<typename T>
+auto Storage<T, std::dynamic_extent>::resource() const noexcept -> std::pmr::memory_resource* {
+    return this->_resource;
+}
+
+}
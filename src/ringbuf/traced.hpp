@@ -0,0 +1,267 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "cache_line.hpp"
+#include "latency.hpp"
+#include "mpmc.hpp"
+#include "ringbuf.hpp"
+#include "spsc.hpp"
+#include "stats.hpp"
+
+namespace core::ringbuf {
+
+/// Clock used to timestamp the elements of a Traced buffer.
+using TraceClock = std::chrono::steady_clock;
+
+/// Element of the buffer wrapped by Traced.
+template<typename T>
+struct Timestamped {
+    T value{};
+    TraceClock::time_point pushed{};
+};
+
+namespace traced_impl {
+
+/// How a buffer type is traced. Only specialised for the buffers Traced supports.
+template<typename Buffer>
+struct Traits;
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+struct Traits<RingBuffer<Timestamped<T>, Capacity, StatsPolicy>> {
+    using Value = T;
+    static constexpr auto SHARING = Sharing::None;
+    static constexpr auto SINGLE_THREADED_SIDES = true;
+};
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+struct Traits<SpscRingBuffer<Timestamped<T>, Capacity, StatsPolicy>> {
+    using Value = T;
+    static constexpr auto SHARING = Sharing::Single;
+    static constexpr auto SINGLE_THREADED_SIDES = true;
+};
+
+template<typename T, size_t Capacity, typename StatsPolicy>
+struct Traits<MpmcRingBuffer<Timestamped<T>, Capacity, StatsPolicy>> {
+    using Value = T;
+    static constexpr auto SHARING = Sharing::Multi;
+    static constexpr auto SINGLE_THREADED_SIDES = false;
+};
+
+}
+
+/// Wraps a ring buffer to measure how long elements spend in it.
+///
+/// Buffer is a RingBuffer, SpscRingBuffer or MpmcRingBuffer of Timestamped elements. Each push
+/// stores the time alongside the value, and each pop records the time since then in latency(),
+/// which is written only by the consumer side and kept on its own cache line. Each call reads the
+/// clock once, so a batch shares one timestamp.
+///
+/// push() and pop() are the non-waiting operations for every buffer type. push_buffer() and
+/// pop_buffer() are only available when each side has a single thread, since they transfer
+/// elements one at a time after checking there's enough space or data. push_wait() takes its
+/// timestamp before waiting, so any time spent blocked on a full buffer is counted too. The
+/// wrapped buffer is available from buffer() for everything else, although values pushed to it
+/// directly need their own timestamp.
+template<typename Buffer>
+struct Traced {
+    using Value = traced_impl::Traits<Buffer>::Value;
+
+    auto push(Value value) noexcept(std::is_nothrow_move_constructible_v<Value>)
+        -> std::expected<void, Error>;
+    auto push_buffer(std::span<const Value> buffer) noexcept(
+        std::is_nothrow_copy_constructible_v<Value>) -> std::expected<void, Error>
+        requires traced_impl::Traits<Buffer>::SINGLE_THREADED_SIDES;
+
+    auto pop() noexcept(std::is_nothrow_move_constructible_v<Value>)
+        -> std::expected<Value, Error>;
+    auto pop_buffer(std::span<Value> buffer) noexcept(std::is_nothrow_move_assignable_v<Value>)
+        -> std::expected<void, Error>
+        requires traced_impl::Traits<Buffer>::SINGLE_THREADED_SIDES;
+
+    auto push_wait(Value value) noexcept -> std::expected<void, Error>
+        requires requires(Buffer& buf, Timestamped<Value> element) {
+            buf.push_wait(std::move(element));
+        };
+    auto pop_wait() noexcept -> std::expected<Value, Error>
+        requires requires(Buffer& buf) { buf.pop_wait(); };
+
+    auto buffer() noexcept -> Buffer&;
+    auto buffer() const noexcept -> const Buffer&;
+
+    auto latency() const noexcept -> const LatencyHistogram<traced_impl::Traits<Buffer>::SHARING>&;
+
+private:
+    static constexpr auto SHARING = traced_impl::Traits<Buffer>::SHARING;
+
+    auto record(const Timestamped<Value>& element, TraceClock::time_point now) noexcept -> void;
+
+    Buffer _buffer{};
+
+    alignas(SHARING == Sharing::None ? alignof(LatencyHistogram<SHARING>) : CACHE_LINE_SIZE)
+        LatencyHistogram<SHARING> _latency{};
+};
+
+template<typename T, size_t Capacity>
+using TracedRingBuffer = Traced<RingBuffer<Timestamped<T>, Capacity>>;
+
+template<typename T, size_t Capacity>
+using TracedSpscRingBuffer = Traced<SpscRingBuffer<Timestamped<T>, Capacity>>;
+
+template<typename T, size_t Capacity>
+using TracedMpmcRingBuffer = Traced<MpmcRingBuffer<Timestamped<T>, Capacity>>;
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename Buffer>
+auto Traced<Buffer>::record(const Timestamped<Value>& element,
+                            const TraceClock::time_point now) noexcept -> void {
+    this->_latency.record(now - element.pushed);
+}
+
+////////////////////////////////////////////////////////////////
+
+template<typename Buffer>
+auto Traced<Buffer>::push(Value value) noexcept(std::is_nothrow_move_constructible_v<Value>)
+    -> std::expected<void, Error> {
+    auto element = Timestamped<Value>{std::move(value), TraceClock::now()};
+
+    if constexpr (requires { this->_buffer.try_push(std::move(element)); }) {
+        return this->_buffer.try_push(std::move(element));
+    } else {
+        return this->_buffer.push(std::move(element));
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Write buffer to the back of the buffer, with a single timestamp for all of it.
+///
+/// @return Error::Full if there isn't space for all of buffer, in which case nothing is written.
+template<typename Buffer>
+auto Traced<Buffer>::push_buffer(const std::span<const Value> buffer) noexcept(
+    std::is_nothrow_copy_constructible_v<Value>) -> std::expected<void, Error>
+    requires traced_impl::Traits<Buffer>::SINGLE_THREADED_SIDES
+{
+    // Only the producer adds elements, so the space can't shrink before they're all written.
+    if (buffer.size() > this->_buffer.free()) {
+        return std::unexpected{Error::Full()};
+    }
+
+    const auto now = TraceClock::now();
+
+    for (const auto& value : buffer) {
+        static_cast<void>(this->_buffer.push(Timestamped<Value>{value, now}));
+    }
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename Buffer>
+auto Traced<Buffer>::pop() noexcept(std::is_nothrow_move_constructible_v<Value>)
+    -> std::expected<Value, Error> {
+    auto element = [this] {
+        if constexpr (requires { this->_buffer.try_pop(); }) {
+            return this->_buffer.try_pop();
+        } else {
+            return this->_buffer.pop();
+        }
+    }();
+
+    if (!element) {
+        return std::unexpected{element.error()};
+    }
+
+    this->record(*element, TraceClock::now());
+    return std::move(element->value);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Fill buffer with the oldest elements, with a single clock read for all of them.
+///
+/// @return Error::Empty if there aren't enough elements, in which case none are taken.
+template<typename Buffer>
+auto Traced<Buffer>::pop_buffer(const std::span<Value> buffer) noexcept(
+    std::is_nothrow_move_assignable_v<Value>) -> std::expected<void, Error>
+    requires traced_impl::Traits<Buffer>::SINGLE_THREADED_SIDES
+{
+    // Only the consumer removes elements, so they can't run out before they're all read.
+    if (buffer.size() > this->_buffer.size()) {
+        return std::unexpected{Error::Empty()};
+    }
+
+    const auto now = TraceClock::now();
+
+    for (auto& value : buffer) {
+        auto element = this->_buffer.pop();
+
+        this->record(*element, now);
+        value = std::move(element->value);
+    }
+
+    return {};
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Push value, blocking until there's space for it.
+///
+/// @return Error::Closed if the buffer was closed first.
+template<typename Buffer>
+auto Traced<Buffer>::push_wait(Value value) noexcept -> std::expected<void, Error>
+    requires requires(Buffer& buf, Timestamped<Value> element) {
+        buf.push_wait(std::move(element));
+    }
+{
+    return this->_buffer.push_wait(Timestamped<Value>{std::move(value), TraceClock::now()});
+}
+
+/// @brief Pop an element, blocking until one is available.
+///
+/// @return Error::Closed if the buffer is empty and was closed.
+template<typename Buffer>
+auto Traced<Buffer>::pop_wait() noexcept -> std::expected<Value, Error>
+    requires requires(Buffer& buf) { buf.pop_wait(); }
+{
+    auto element = this->_buffer.pop_wait();
+
+    if (!element) {
+        return std::unexpected{element.error()};
+    }
+
+    this->record(*element, TraceClock::now());
+    return std::move(element->value);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename Buffer>
+auto Traced<Buffer>::buffer() noexcept -> Buffer& {
+    return this->_buffer;
+}
+
+template<typename Buffer>
+auto Traced<Buffer>::buffer() const noexcept -> const Buffer& {
+    return this->_buffer;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Get the histogram of the time elements spent in the buffer.
+template<typename Buffer>
+auto Traced<Buffer>::latency() const noexcept
+    -> const LatencyHistogram<traced_impl::Traits<Buffer>::SHARING>& {
+    return this->_latency;
+}
+
+}
@@ -0,0 +1,220 @@
+#if defined(__linux__)
+    #include <linux/futex.h>
+    #include <linux/membarrier.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#else
+    #include <thread>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <ctime>
+
+#include "wait.hpp"
+
+namespace {
+
+/// Register for expedited private membarrier() calls, which heavy_fence() relies on.
+///
+/// @return true if heavy_fence() can use them.
+auto register_membarrier() noexcept -> bool {
+#if defined(__linux__)
+    const auto supported = syscall(SYS_membarrier, MEMBARRIER_CMD_QUERY, 0, 0);
+
+    return supported != -1 && (supported & MEMBARRIER_CMD_PRIVATE_EXPEDITED) != 0
+           && syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+#else
+    return false;
+#endif
+}
+
+}
+
+const bool core::ringbuf::wait_impl::ASYMMETRIC_FENCES = register_membarrier();
+
+/// Uses an expedited membarrier() where available, which interrupts every running thread of the
+/// process with a full barrier. That is far more expensive than a fence, but waiters are about to
+/// block anyway, and it spares notifiers from fencing on every operation.
+auto core::ringbuf::wait_impl::heavy_fence() noexcept -> void {
+#if defined(__linux__)
+    if (ASYMMETRIC_FENCES) {
+        syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+        return;
+    }
+#endif
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+/// Uses the futex syscall directly on Linux, since std::atomic::wait() has no timeout. Elsewhere
+/// untimed waits use std::atomic::wait() and timed waits poll.
+auto core::ringbuf::wait_impl::park(std::atomic<uint32_t>& word,
+                                    const uint32_t expected,
+                                    const Deadline deadline) noexcept -> bool {
+#if defined(__linux__)
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+    using namespace std::chrono;
+
+    // FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC time, which is what steady_clock uses.
+    auto timeout = timespec{};
+
+    if (deadline) {
+        const auto since_epoch = std::max(deadline->time_since_epoch(), nanoseconds{0});
+        const auto seconds = duration_cast<std::chrono::seconds>(since_epoch);
+        const auto remainder = duration_cast<nanoseconds>(since_epoch - seconds);
+
+        timeout.tv_sec = static_cast<time_t>(seconds.count());
+        timeout.tv_nsec = static_cast<long>(remainder.count());
+    }
+
+    const auto result = syscall(SYS_futex,
+                                reinterpret_cast<uint32_t*>(&word),
+                                FUTEX_WAIT_BITSET_PRIVATE,
+                                expected,
+                                deadline ? &timeout : nullptr,
+                                nullptr,
+                                FUTEX_BITSET_MATCH_ANY);
+
+    return !(result == -1 && errno == ETIMEDOUT);
+#else
+    if (!deadline) {
+        word.wait(expected, std::memory_order_acquire);
+        return true;
+    }
+
+    while (word.load(std::memory_order_acquire) == expected) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= *deadline) {
+            return false;
+        }
+
+        constexpr auto POLL_INTERVAL = std::chrono::microseconds{50};
+        const auto remaining = std::chrono::nanoseconds{*deadline - now};
+        std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(remaining, POLL_INTERVAL));
+    }
+
+    return true;
+#endif
+}
+
+auto core::ringbuf::wait_impl::wake_all(std::atomic<uint32_t>& word) noexcept -> void {
+#if defined(__linux__)
+    syscall(SYS_futex,
+            reinterpret_cast<uint32_t*>(&word),
+            FUTEX_WAKE_PRIVATE,
+            INT_MAX,
+            nullptr,
+            nullptr,
+            0);
+#else
+    word.notify_all();
+#endif
+}
+
+auto core::ringbuf::wait_impl::wake_one(std::atomic<uint32_t>& word) noexcept -> void {
+#if defined(__linux__)
+    syscall(SYS_futex,
+            reinterpret_cast<uint32_t*>(&word),
+            FUTEX_WAKE_PRIVATE,
+            1,
+            nullptr,
+            nullptr,
+            0);
+#else
+    word.notify_one();
+#endif
+}
+
+////////////////////////////////////////////////////////////////
+
+auto core::ringbuf::WaitQueue::link(Awaiter& awaiter) noexcept -> void {
+    awaiter.next = nullptr;
+    awaiter.prev = this->_tail;
+    awaiter.queued = true;
+
+    if (this->_tail != nullptr) {
+        this->_tail->next = &awaiter;
+    } else {
+        this->_head = &awaiter;
+    }
+
+    this->_tail = &awaiter;
+}
+
+auto core::ringbuf::WaitQueue::unlink(Awaiter& awaiter) noexcept -> void {
+    if (awaiter.prev != nullptr) {
+        awaiter.prev->next = awaiter.next;
+    } else {
+        this->_head = awaiter.next;
+    }
+
+    if (awaiter.next != nullptr) {
+        awaiter.next->prev = awaiter.prev;
+    } else {
+        this->_tail = awaiter.prev;
+    }
+
+    awaiter.next = nullptr;
+    awaiter.prev = nullptr;
+    awaiter.queued = false;
+
+    if (this->_head == nullptr) {
+        this->_suspended.store(0, std::memory_order_relaxed);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Remove awaiter from the queue if it's still queued.
+///
+/// @return true if it was removed, in which case the caller is responsible for resuming it.
+auto core::ringbuf::WaitQueue::remove(Awaiter& awaiter) noexcept -> bool {
+    this->lock();
+
+    const auto queued = awaiter.queued;
+    if (queued) {
+        this->unlink(awaiter);
+    }
+
+    this->unlock();
+    return queued;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// Complete operations from the front of the queue until one can't proceed, then resume their
+/// coroutines outside the lock so they're free to use the buffer again.
+auto core::ringbuf::WaitQueue::resume_ready() noexcept -> bool {
+    auto* ready = static_cast<Awaiter*>(nullptr);
+    auto* last = static_cast<Awaiter*>(nullptr);
+
+    this->lock();
+
+    while (this->_head != nullptr && this->_head->complete(*this->_head)) {
+        auto& awaiter = *this->_head;
+        this->unlink(awaiter);
+
+        if (last != nullptr) {
+            last->next = &awaiter;
+        } else {
+            ready = &awaiter;
+        }
+
+        last = &awaiter;
+    }
+
+    this->unlock();
+
+    const auto completed = ready != nullptr;
+
+    while (ready != nullptr) {
+        // The coroutine may destroy its awaiter once resumed.
+        auto* const next = ready->next;
+        ready->handle.resume();
+        ready = next;
+    }
+
+    return completed;
+}
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <optional>
+
+namespace core::ringbuf {
+
+using Deadline = std::optional<std::chrono::steady_clock::time_point>;
+
+namespace wait_impl {
+
+/// Block while word holds expected, until woken or deadline passes.
+///
+/// @return false if deadline passed.
+auto park(std::atomic<uint32_t>& word, uint32_t expected, Deadline deadline) noexcept -> bool;
+
+/// Wake every thread parked on word.
+auto wake_all(std::atomic<uint32_t>& word) noexcept -> void;
+
+/// Wake at most one thread parked on word.
+auto wake_one(std::atomic<uint32_t>& word) noexcept -> void;
+
+/// Whether heavy_fence() also orders the light_fence() calls of every other thread. Set once during
+/// static initialisation.
+extern const bool ASYMMETRIC_FENCES;
+
+/// Order the caller's earlier writes before its later reads, pairing with heavy_fence().
+///
+/// Where the OS can run a barrier on every thread of the process on heavy_fence()'s behalf, this
+/// is only a compiler barrier.
+inline auto light_fence() noexcept -> void {
+    if (ASYMMETRIC_FENCES) {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    } else {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+/// Order the caller's earlier writes before its later reads, and those of every thread which has
+/// called light_fence().
+auto heavy_fence() noexcept -> void;
+
+/// Hint to the CPU that the caller is spinning.
+inline auto relax() noexcept -> void {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+}
+
+/// A suspended coroutine queued in a WaitQueue.
+///
+/// Rather than resuming the coroutine to retry its operation, notify() calls complete() to retry
+/// it on the coroutine's behalf, and only resumes the coroutine once that succeeds. So a resumed
+/// coroutine always has its result, even when it competes with other threads for the buffer.
+struct Awaiter {
+    /// Retry the awaited operation, storing its result.
+    ///
+    /// @return true if the operation is finished and the coroutine should be resumed.
+    using Complete = auto (*)(Awaiter& awaiter) noexcept -> bool;
+
+    Complete complete{};
+    std::coroutine_handle<> handle{};
+
+private:
+    friend struct WaitQueue;
+
+    Awaiter* next{};
+    Awaiter* prev{};
+    bool queued{};
+};
+
+/// Threads and coroutines waiting for one side of a concurrent ring buffer to make progress.
+///
+/// A thread first spins for a while, retrying its operation, before it parks on a futex. The spin
+/// budget adapts: it doubles whenever spinning was enough and halves whenever the waiter had to
+/// park anyway. Coroutines are queued in FIFO order under a short spinlock and resumed by whichever
+/// thread calls notify().
+///
+/// notify() must be called after every operation that could let a waiter proceed. Waiters and
+/// notify() each need a seq_cst fence between publishing and checking, so that either the waiter
+/// sees the notifier's write or the notifier sees the waiter. On Linux the waiter's side is a
+/// membarrier() syscall, which runs that fence on the notifier's behalf, so notify() only costs a
+/// compiler barrier and a load of a counter and a flag. Elsewhere it also costs a full fence.
+///
+/// Parked threads sleep on an epoch which each wake-up bumps, so notify_one() can wake a single
+/// thread without the others missing later wake-ups.
+struct WaitQueue {
+    template<typename F>
+    auto wait_until(F&& attempt, Deadline deadline) noexcept -> bool;
+
+    template<typename F>
+    auto suspend(Awaiter& awaiter, F&& attempt) noexcept -> bool;
+    auto remove(Awaiter& awaiter) noexcept -> bool;
+
+    auto notify() noexcept -> bool;
+    auto notify_one() noexcept -> bool;
+
+private:
+    static constexpr auto MIN_SPINS = uint32_t{16};
+    static constexpr auto MAX_SPINS = uint32_t{4096};
+
+    auto lock() noexcept -> void;
+    auto unlock() noexcept -> void;
+
+    auto link(Awaiter& awaiter) noexcept -> void;
+    auto unlink(Awaiter& awaiter) noexcept -> void;
+
+    auto wake(bool all) noexcept -> bool;
+    auto resume_ready() noexcept -> bool;
+
+    /// Number of threads parked or about to park, and the futex word they park on.
+    std::atomic<uint32_t> _parked{};
+    std::atomic<uint32_t> _epoch{};
+    std::atomic<uint32_t> _suspended{};
+    std::atomic<uint32_t> _spins{MIN_SPINS};
+
+    std::atomic_flag _lock{};
+    Awaiter* _head{};
+    Awaiter* _tail{};
+};
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Call attempt until it returns true or deadline passes.
+///
+/// @return The result of the last call to attempt.
+template<typename F>
+auto WaitQueue::wait_until(F&& attempt, const Deadline deadline) noexcept -> bool {
+    const auto spins = this->_spins.load(std::memory_order_relaxed);
+
+    for (auto i = uint32_t{0}; i < spins; i++) {
+        if (attempt()) {
+            this->_spins.store(std::min(spins * 2, MAX_SPINS), std::memory_order_relaxed);
+            return true;
+        }
+
+        wait_impl::relax();
+    }
+
+    this->_spins.store(std::max(spins / 2, MIN_SPINS), std::memory_order_relaxed);
+
+    while (true) {
+        // Read before the attempt, so a wake-up after it makes park() return straight away.
+        const auto epoch = this->_epoch.load(std::memory_order_relaxed);
+
+        // Pairs with the fence in notify(). Either the notifier sees this thread counted or the
+        // attempt sees whatever the notifier published.
+        this->_parked.fetch_add(1, std::memory_order_relaxed);
+        wait_impl::heavy_fence();
+
+        if (attempt()) {
+            this->_parked.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        const auto woken = wait_impl::park(this->_epoch, epoch, deadline);
+        this->_parked.fetch_sub(1, std::memory_order_relaxed);
+
+        if (!woken) {
+            return attempt();
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Queue awaiter unless attempt succeeds first.
+///
+/// attempt is called under the queue's lock, after the queue is flagged as having waiters, so a
+/// concurrent notify() either sees the flag or attempt sees what the notifier published. Once
+/// queued the awaiter may be resumed by another thread before this returns.
+///
+/// @return true if awaiter was queued, false if attempt succeeded.
+template<typename F>
+auto WaitQueue::suspend(Awaiter& awaiter, F&& attempt) noexcept -> bool {
+    this->lock();
+
+    this->_suspended.store(1, std::memory_order_relaxed);
+    wait_impl::heavy_fence();
+
+    if (attempt()) {
+        if (this->_head == nullptr) {
+            this->_suspended.store(0, std::memory_order_relaxed);
+        }
+
+        this->unlock();
+        return false;
+    }
+
+    this->link(awaiter);
+    this->unlock();
+
+    return true;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Wake any parked threads and resume any coroutines whose operation now completes.
+///
+/// @return true if an operation was completed on behalf of a coroutine, in which case the other
+///         side of the buffer may be able to make progress too.
+inline auto WaitQueue::notify() noexcept -> bool {
+    return this->wake(true);
+}
+
+/// @brief Wake one parked thread and resume any coroutines whose operation now completes.
+///
+/// For when what was published can only let one waiter proceed, such as a single task, so the rest
+/// aren't woken only to park again.
+///
+/// @return true if an operation was completed on behalf of a coroutine.
+inline auto WaitQueue::notify_one() noexcept -> bool {
+    return this->wake(false);
+}
+
+inline auto WaitQueue::wake(const bool all) noexcept -> bool {
+    wait_impl::light_fence();
+
+    if (this->_parked.load(std::memory_order_relaxed) != 0) {
+        this->_epoch.fetch_add(1, std::memory_order_relaxed);
+
+        if (all) {
+            wait_impl::wake_all(this->_epoch);
+        } else {
+            wait_impl::wake_one(this->_epoch);
+        }
+    }
+
+    if (this->_suspended.load(std::memory_order_relaxed) != 0) {
+        return this->resume_ready();
+    }
+
+    return false;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+inline auto WaitQueue::lock() noexcept -> void {
+    while (this->_lock.test_and_set(std::memory_order_acquire)) {
+        wait_impl::relax();
+    }
+}
+
+inline auto WaitQueue::unlock() noexcept -> void {
+    this->_lock.clear(std::memory_order_release);
+}
+
+}
+
+/*------------------------------------------------------------------------------------------------*/
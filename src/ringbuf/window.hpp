@@ -0,0 +1,287 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+#include "overwrite.hpp"
+#include "ringbuf.hpp"
+
+namespace core::ringbuf {
+
+namespace window_impl {
+
+/// Type a running sum of T is kept in. Integers are summed in 64 bits, so that a window of narrow
+/// samples can't overflow.
+template<typename T>
+using Sum = std::conditional_t<std::floating_point<T>,
+                               T,
+                               std::conditional_t<std::signed_integral<T>, int64_t, uint64_t>>;
+
+/// Fixed capacity deque of samples kept in monotonic order by Compare, front first.
+///
+/// Pushing a sample first drops every sample at the back which it beats, so the front is always
+/// the extreme of the samples still in the window. Each sample is pushed and dropped once, so
+/// updates are O(1) amortised.
+template<typename T, size_t Capacity, typename Compare>
+struct MonotonicQueue {
+    auto push(T value, uint64_t sequence) noexcept -> void;
+    auto evict(uint64_t sequence) noexcept -> void;
+    auto clear() noexcept -> void;
+
+    auto front() const noexcept -> const T&;
+
+private:
+    struct Entry {
+        T value{};
+        uint64_t sequence{};
+    };
+
+    static auto wrap(size_t index) noexcept -> size_t;
+
+    std::array<Entry, Capacity> _entries{};
+    size_t _head{};
+    size_t _size{};
+};
+
+}
+
+/// Moving window over the last Capacity samples which keeps their sum, mean, min and max.
+///
+/// Samples are kept in an OverwriteRingBuffer, so pushing to a full window evicts the oldest
+/// sample. The sum is updated by adding the new sample and subtracting the evicted one, and min()
+/// and max() are the fronts of monotonic queues, so every push is O(1) amortised however large the
+/// window is.
+///
+/// For floating point samples the running sum is compensated, so the error from repeatedly adding
+/// and subtracting doesn't build up over the lifetime of the window. Integer samples are summed in
+/// a 64 bit Sum, so only 64 bit samples can overflow it.
+template<typename T, size_t Capacity>
+struct SlidingWindow {
+    static_assert(std::is_arithmetic_v<T> && !std::same_as<T, bool>);
+    static_assert(Capacity > 0 && Capacity != std::dynamic_extent);
+
+    using Sum = window_impl::Sum<T>;
+
+    auto push(T value) noexcept -> void;
+    auto clear() noexcept -> void;
+
+    auto sum() const noexcept -> Sum;
+    auto mean() const noexcept -> std::expected<T, Error>;
+    auto min() const noexcept -> std::expected<T, Error>;
+    auto max() const noexcept -> std::expected<T, Error>;
+
+    auto samples() const noexcept -> const OverwriteRingBuffer<T, Capacity>&;
+
+    auto empty() const noexcept -> bool;
+    auto full() const noexcept -> bool;
+    auto size() const noexcept -> size_t;
+    auto capacity() const noexcept -> size_t;
+
+private:
+    auto add(T value) noexcept -> void;
+    auto subtract(T value) noexcept -> void;
+
+    OverwriteRingBuffer<T, Capacity> _samples{};
+
+    /// Sequence number of the next sample pushed.
+    uint64_t _pushed{};
+
+    Sum _sum{};
+
+    /// Low order bits lost from _sum, for floating point samples.
+    [[no_unique_address]] std::conditional_t<std::floating_point<T>, T, std::tuple<>> _error{};
+
+    window_impl::MonotonicQueue<T, Capacity, std::less<>> _min{};
+    window_impl::MonotonicQueue<T, Capacity, std::greater<>> _max{};
+};
+
+/*------------------------------------------------------------------------------------------------*/
+// Class method definitions.
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity, typename Compare>
+auto window_impl::MonotonicQueue<T, Capacity, Compare>::wrap(const size_t index) noexcept
+    -> size_t {
+    return index >= Capacity ? index - Capacity : index;
+}
+
+template<typename T, size_t Capacity, typename Compare>
+auto window_impl::MonotonicQueue<T, Capacity, Compare>::push(const T value,
+                                                             const uint64_t sequence) noexcept
+    -> void {
+    while (this->_size > 0 &&
+           !Compare{}(this->_entries[wrap(this->_head + this->_size - 1)].value, value)) {
+        this->_size--;
+    }
+
+    this->_entries[wrap(this->_head + this->_size)] = Entry{value, sequence};
+    this->_size++;
+}
+
+/// Drop the sample with sequence number sequence, which must be the oldest in the window.
+template<typename T, size_t Capacity, typename Compare>
+auto window_impl::MonotonicQueue<T, Capacity, Compare>::evict(const uint64_t sequence) noexcept
+    -> void {
+    if (this->_size > 0 && this->_entries[this->_head].sequence == sequence) {
+        this->_head = wrap(this->_head + 1);
+        this->_size--;
+    }
+}
+
+template<typename T, size_t Capacity, typename Compare>
+auto window_impl::MonotonicQueue<T, Capacity, Compare>::clear() noexcept -> void {
+    this->_head = 0;
+    this->_size = 0;
+}
+
+template<typename T, size_t Capacity, typename Compare>
+auto window_impl::MonotonicQueue<T, Capacity, Compare>::front() const noexcept -> const T& {
+    return this->_entries[this->_head].value;
+}
+
+////////////////////////////////////////////////////////////////
+
+/// Add value to the running sum, using Neumaier's compensated summation for floating point types.
+template<typename T, size_t Capacity>
+auto SlidingWindow<T, Capacity>::add(const T value) noexcept -> void {
+    if constexpr (std::floating_point<T>) {
+        const auto sum = this->_sum + value;
+
+        if (std::abs(this->_sum) >= std::abs(value)) {
+            this->_error += (this->_sum - sum) + value;
+        } else {
+            this->_error += (value - sum) + this->_sum;
+        }
+
+        this->_sum = sum;
+    } else {
+        this->_sum += static_cast<Sum>(value);
+    }
+}
+
+template<typename T, size_t Capacity>
+auto SlidingWindow<T, Capacity>::subtract(const T value) noexcept -> void {
+    if constexpr (std::floating_point<T>) {
+        this->add(-value);
+    } else {
+        this->_sum -= static_cast<Sum>(value);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Add value to the window, evicting the oldest sample if it's full.
+template<typename T, size_t Capacity>
+auto SlidingWindow<T, Capacity>::push(const T value) noexcept -> void {
+    if (this->_samples.full()) {
+        const auto oldest = this->_pushed - Capacity;
+
+        this->subtract(this->_samples.peek_read().first.front());
+        this->_min.evict(oldest);
+        this->_max.evict(oldest);
+    }
+
+    this->_samples.push(value);
+    this->add(value);
+    this->_min.push(value, this->_pushed);
+    this->_max.push(value, this->_pushed);
+    this->_pushed++;
+}
+
+template<typename T, size_t Capacity>
+auto SlidingWindow<T, Capacity>::clear() noexcept -> void {
+    this->_samples.clear();
+    this->_sum = Sum{};
+    this->_error = {};
+    this->_min.clear();
+    this->_max.clear();
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Get the sum of the samples in the window, which is zero when it's empty.
+template<typename T, size_t Capacity>
+auto SlidingWindow<T, Capacity>::sum() const noexcept -> Sum {
+    if constexpr (std::floating_point<T>) {
+        return this->_sum + this->_error;
+    } else {
+        return this->_sum;
+    }
+}
+
+/// @brief Get the mean of the samples in the window, rounded towards zero for integer types.
+///
+/// @return Error::Empty if there aren't any samples.
+template<typename T, size_t Capacity>
+auto SlidingWindow<T, Capacity>::mean() const noexcept -> std::expected<T, Error> {
+    if (this->empty()) {
+        return std::unexpected{Error::Empty()};
+    }
+
+    return static_cast<T>(this->sum() / static_cast<Sum>(this->size()));
+}
+
+/// @brief Get the smallest sample in the window.
+///
+/// @return Error::Empty if there aren't any samples.
+template<typename T, size_t Capacity>
+auto SlidingWindow<T, Capacity>::min() const noexcept -> std::expected<T, Error> {
+    if (this->empty()) {
+        return std::unexpected{Error::Empty()};
+    }
+
+    return this->_min.front();
+}
+
+/// @brief Get the largest sample in the window.
+///
+/// @return Error::Empty if there aren't any samples.
+template<typename T, size_t Capacity>
+auto SlidingWindow<T, Capacity>::max() const noexcept -> std::expected<T, Error> {
+    if (this->empty()) {
+        return std::unexpected{Error::Empty()};
+    }
+
+    return this->_max.front();
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+/// @brief Get the samples in the window, oldest first.
+template<typename T, size_t Capacity>
+auto SlidingWindow<T, Capacity>::samples() const noexcept
+    -> const OverwriteRingBuffer<T, Capacity>& {
+    return this->_samples;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+template<typename T, size_t Capacity>
+auto SlidingWindow<T, Capacity>::empty() const noexcept -> bool {
+    return this->_samples.empty();
+}
+
+template<typename T, size_t Capacity>
+auto SlidingWindow<T, Capacity>::full() const noexcept -> bool {
+    return this->_samples.full();
+}
+
+template<typename T, size_t Capacity>
+auto SlidingWindow<T, Capacity>::size() const noexcept -> size_t {
+    return this->_samples.size();
+}
+
+template<typename T, size_t Capacity>
+auto SlidingWindow<T, Capacity>::capacity() const noexcept -> size_t {
+    return Capacity;
+}
+
+}
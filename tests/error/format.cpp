@@ -0,0 +1,193 @@
+/// Tests for formatting errors and their source chains.
+
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "error.hpp"
+
+////////////////////////////////////////////////////////////////
+
+/// Error which formats as its name and can be formatted as another error's source.
+struct Named: error::Error {
+    explicit Named(const char* const name, const error::Error* const inner = nullptr) :
+        name{name}, inner{inner} {}
+
+    auto source() const noexcept
+        -> std::optional<std::reference_wrapper<const error::Error>> override {
+        if (this->inner == nullptr) {
+            return std::nullopt;
+        }
+
+        return std::cref(*this->inner);
+    }
+
+    auto format_to_n(char* const out, const std::size_t n) const noexcept
+        -> std::optional<std::format_to_n_result<char*>> override {
+        return std::format_to_n(out, static_cast<std::ptrdiff_t>(n), "{}", *this);
+    }
+
+    const char* name;
+    const error::Error* inner;
+};
+
+/// Error which doesn't override format_to_n(), so it's left out of chains.
+struct Unnamed: error::Error {
+    explicit Unnamed(const error::Error* const inner = nullptr) : inner{inner} {}
+
+    auto source() const noexcept
+        -> std::optional<std::reference_wrapper<const error::Error>> override {
+        if (this->inner == nullptr) {
+            return std::nullopt;
+        }
+
+        return std::cref(*this->inner);
+    }
+
+    const error::Error* inner;
+};
+
+/// Error which formats to an empty message, but still supports format_to_n().
+struct Blank: error::Error {
+    auto format_to_n(char* const out, [[maybe_unused]] const std::size_t n) const noexcept
+        -> std::optional<std::format_to_n_result<char*>> override {
+        return std::format_to_n_result<char*>{out, 0};
+    }
+};
+
+/// Error without a format_to_n() override.
+struct Root: error::Error {};
+
+/// Error with a StaticSource, so it's formatted through its std::formatter in chains.
+template<typename S>
+struct Wrapper: error::Error {
+    using Source = S;
+
+    explicit Wrapper(S inner) : inner{std::move(inner)} {}
+
+    auto source() const noexcept
+        -> std::optional<std::reference_wrapper<const error::Error>> override {
+        return std::cref(this->inner);
+    }
+
+    S inner;
+};
+
+using Middle = Wrapper<Root>;
+using Top = Wrapper<Middle>;
+
+ERROR_DERIVE_FMT(Named, "{}", self.name)
+ERROR_DERIVE_FMT(Unnamed, "unnamed")
+ERROR_DERIVE_FMT(Blank, "")
+ERROR_DERIVE_FMT(Root, "root")
+ERROR_DERIVE_FMT(Middle, "middle")
+ERROR_DERIVE_FMT(Top, "top")
+ERROR_DERIVE_FMT(Wrapper<Named>, "wrapper")
+
+static_assert(error::ErrorType<Named>);
+static_assert(error::ErrorType<Unnamed>);
+static_assert(error::StaticSource<Top>);
+
+////////////////////////////////////////////////////////////////
+
+/// Format error's chain into a buffer of n characters.
+template<size_t N>
+auto format_chain(const auto& error, const size_t n = N) -> std::pair<std::string, std::ptrdiff_t> {
+    char out[N]{};
+    const auto result = error::format_chain_to_n(out, n, error);
+
+    return {std::string{out, result.out}, result.size};
+}
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("An error is formatted with its source chain") {
+    GIVEN("An error without a source") {
+        const auto error = Named{"outer"};
+
+        THEN("Only the error itself should be formatted") {
+            REQUIRE(format_chain<64>(error) == std::pair{std::string{"outer"}, std::ptrdiff_t{5}});
+        }
+    }
+
+    GIVEN("A chain of errors which all override format_to_n()") {
+        const auto root = Named{"root"};
+        const auto middle = Named{"middle", &root};
+        const auto error = Named{"outer", &middle};
+
+        THEN("Each should be formatted, separated by \": \"") {
+            REQUIRE(format_chain<64>(error).first == "outer: middle: root");
+            REQUIRE(format_chain<64>(error).second == 19);
+        }
+
+        THEN("Formatting into a short buffer should truncate it but report the full size") {
+            REQUIRE(format_chain<64>(error, 9).first == "outer: mi");
+            REQUIRE(format_chain<64>(error, 9).second == 19);
+
+            REQUIRE(format_chain<64>(error, 6).first == "outer:");
+            REQUIRE(format_chain<64>(error, 3).first == "out");
+            REQUIRE(format_chain<64>(error, 0).first.empty());
+            REQUIRE(format_chain<64>(error, 0).second == 19);
+        }
+    }
+
+    GIVEN("A chain through an error which doesn't override format_to_n()") {
+        const auto root = Named{"root"};
+        const auto middle = Unnamed{&root};
+        const auto error = Named{"outer", &middle};
+
+        THEN("It should be skipped along with its separator") {
+            REQUIRE(format_chain<64>(error).first == "outer: root");
+            REQUIRE(format_chain<64>(error).second == 11);
+        }
+    }
+
+    GIVEN("An error whose only source doesn't override format_to_n()") {
+        const auto middle = Unnamed{};
+        const auto error = Named{"outer", &middle};
+
+        THEN("No separator should be left dangling") {
+            REQUIRE(format_chain<64>(error).first == "outer");
+            REQUIRE(format_chain<64>(error).second == 5);
+        }
+    }
+
+    GIVEN("An error whose source formats to an empty message") {
+        const auto middle = Blank{};
+        const auto error = Named{"outer", &middle};
+
+        THEN("Its separator should still be written") {
+            REQUIRE(format_chain<64>(error).first == "outer: ");
+            REQUIRE(format_chain<64>(error).second == 7);
+        }
+    }
+
+    GIVEN("A chain of StaticSources which don't override format_to_n()") {
+        const auto error = Top{Middle{Root{}}};
+
+        THEN("Each should be formatted through its formatter") {
+            REQUIRE(format_chain<64>(error).first == "top: middle: root");
+            REQUIRE(format_chain<64>(error).second == 17);
+        }
+
+        THEN("Formatting into a short buffer should truncate it but report the full size") {
+            REQUIRE(format_chain<64>(error, 8).first == "top: mid");
+            REQUIRE(format_chain<64>(error, 8).second == 17);
+        }
+    }
+
+    GIVEN("A StaticSource whose source isn't one") {
+        const auto root = Named{"root"};
+        const auto middle = Named{"middle", &root};
+        const auto error = Wrapper<Named>{middle};
+
+        THEN("The rest of the chain should be formatted through format_to_n()") {
+            REQUIRE(format_chain<64>(error).first == "wrapper: middle: root");
+        }
+    }
+}
@@ -0,0 +1,162 @@
+/// Tests for the compile-time codes and source chains of Variants.
+
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "error.hpp"
+
+////////////////////////////////////////////////////////////////
+
+struct Root: error::Error {};
+struct Other: error::Error {};
+
+/// Never part of the Variants below.
+struct Stray: error::Error {};
+
+/// Error with a StaticSource, so its chain can be followed at compile time.
+template<typename S>
+struct Wrapper: error::Error {
+    using Source = S;
+
+    auto source() const noexcept
+        -> std::optional<std::reference_wrapper<const error::Error>> override {
+        return std::cref(this->inner);
+    }
+
+    S inner{};
+};
+
+using Middle = Wrapper<Root>;
+using Top = Wrapper<Middle>;
+
+ERROR_DERIVE_FMT(Root, "root")
+ERROR_DERIVE_FMT(Other, "other")
+ERROR_DERIVE_FMT(Stray, "stray")
+ERROR_DERIVE_FMT(Middle, "middle")
+ERROR_DERIVE_FMT(Top, "top")
+
+/// Empty tags, so a Variant of them is stateless.
+struct Ping: error::TrivialError {};
+struct Pong: error::TrivialError {};
+
+ERROR_DERIVE_FMT(Ping, "ping")
+ERROR_DERIVE_FMT(Pong, "pong")
+
+using Tags = error::Variant<Ping, Pong>;
+
+struct Inner: error::Variant<Other, Root> {
+    using Variant = error::Variant<Other, Root>;
+    using Variant::Variant;
+};
+
+struct Outer: error::Variant<Top, Inner> {
+    using Variant = error::Variant<Top, Inner>;
+    using Variant::Variant;
+};
+
+////////////////////////////////////////////////////////////////
+
+// Top's chain is found first, then Inner's alternatives, skipping Root which was already found.
+static_assert(std::same_as<Outer::Reachable, error::variant_impl::List<Top, Middle, Root, Other>>);
+
+static_assert(Outer::CODE<Top> == 0);
+static_assert(Outer::CODE<Middle> == 1);
+static_assert(Outer::CODE<Root> == 2);
+static_assert(Outer::CODE<Other> == 3);
+
+static_assert(Outer::REACHABLE<Middle>);
+static_assert(!Outer::REACHABLE<Stray>);
+static_assert(!Inner::REACHABLE<Top>);
+
+template<typename V, typename E>
+concept HasGetMut = requires(V variant) { variant.template get_mut<E>(); };
+
+// A stateless Variant has no state to hand out mutable references to.
+static_assert(std::is_trivially_copyable_v<Tags>);
+static_assert(!HasGetMut<Tags, Ping>);
+static_assert(HasGetMut<Outer::Variant, Top>);
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("A Variant reports the codes of the errors it holds") {
+    GIVEN("A Variant holding an error with a static source chain") {
+        const auto error = Outer{Top{}};
+
+        THEN("Its code should be that of the held error") {
+            REQUIRE(error.code() == Outer::CODE<Top>);
+        }
+
+        THEN("Its chain should hold the code of every error in the source chain") {
+            REQUIRE(error.chain() == 0b0111);
+        }
+
+        THEN("It should contain each error in the chain and nothing else") {
+            REQUIRE(error.contains<Top>());
+            REQUIRE(error.contains<Middle>());
+            REQUIRE(error.contains<Root>());
+            REQUIRE(!error.contains<Other>());
+            REQUIRE(!error.contains<Stray>());
+        }
+    }
+
+    GIVEN("A Variant holding a nested Variant") {
+        const auto error = Outer{Inner{Other{}}};
+
+        THEN("Its code should be that of the error held by the nested Variant") {
+            REQUIRE(error.code() == Outer::CODE<Other>);
+            REQUIRE(Inner{Other{}}.code() == Inner::CODE<Other>);
+        }
+
+        THEN("Its chain should only hold that error") {
+            REQUIRE(error.chain() == 0b1000);
+            REQUIRE(error.contains<Other>());
+            REQUIRE(!error.contains<Root>());
+        }
+    }
+
+    GIVEN("A nested Variant holding an error which is also reachable through a source chain") {
+        const auto error = Outer{Inner{Root{}}};
+
+        THEN("It should have the same code however it was reached") {
+            REQUIRE(error.code() == Outer::CODE<Root>);
+            REQUIRE(error.chain() == 0b0100);
+            REQUIRE(error.contains<Root>());
+            REQUIRE(!error.contains<Top>());
+        }
+    }
+}
+
+SCENARIO("A Variant implements the interface of its base") {
+    GIVEN("A Variant of errors deriving from Error") {
+        const auto error = Outer{Top{}};
+        const error::Error& base = error;
+
+        THEN("It should be formatted and followed through its Error base") {
+            char out[8]{};
+            const auto result = base.format_to_n(out, sizeof(out));
+
+            REQUIRE(result.has_value());
+            REQUIRE(std::string_view{out, result->out} == "top");
+            REQUIRE(base.source().has_value());
+        }
+    }
+
+    GIVEN("A stateless Variant") {
+        auto error = Tags{Pong{}};
+
+        THEN("visit_mut() should call the visitor with the held alternative") {
+            const auto visited = error.visit_mut([]<typename E>(E&& /*unused*/) {
+                return std::same_as<E, Pong&>;
+            });
+
+            REQUIRE(visited);
+            REQUIRE(error.is<Pong>());
+        }
+    }
+}
@@ -0,0 +1,123 @@
+/// Tests for the panic sink, buffer and backtraces.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "panic.hpp"
+
+////////////////////////////////////////////////////////////////
+
+/// Messages passed to record_sink().
+auto recorded = std::string{};
+
+auto record_sink(const std::span<const char> message) noexcept -> void {
+    recorded.append(message.data(), message.size());
+}
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("The panic sink can be replaced") {
+    GIVEN("The default sink") {
+        const auto original = panic_impl::get_sink();
+        REQUIRE(original != nullptr);
+
+        WHEN("Another sink is set") {
+            panic_impl::set_sink(&record_sink);
+
+            THEN("It should be returned by get_sink()") {
+                REQUIRE(panic_impl::get_sink() == &record_sink);
+            }
+
+            panic_impl::set_sink(original);
+        }
+    }
+}
+
+// The buffer can only be claimed once per process, and Catch2 reruns a scenario for each of its
+// leaf sections, so everything which claims it is in a single section.
+SCENARIO("The panic buffer is claimed once and its message reported through the sink") {
+    GIVEN("A recording sink") {
+        const auto original = panic_impl::get_sink();
+        panic_impl::set_sink(&record_sink);
+
+        THEN("Only the first claim should get the buffer, and its message should reach the sink") {
+            const auto first = panic_impl::claim_buffer();
+            const auto second = panic_impl::claim_buffer();
+
+            REQUIRE(first.size() >= panic_impl::BUFFER_SIZE + panic_impl::BACKTRACE_SIZE);
+            REQUIRE(second.empty());
+
+            const auto message = std::string_view{"panic!: test\r\n"};
+            message.copy(first.data(), message.size());
+            panic_impl::report(first.first(message.size()));
+
+            REQUIRE(recorded == message);
+
+            // Once reported, waiting shouldn't block on this thread or any other.
+            panic_impl::wait_for_report();
+            std::jthread{[] { panic_impl::wait_for_report(); }}.join();
+        }
+
+        panic_impl::set_sink(original);
+    }
+}
+
+SCENARIO("A backtrace is written as one line per return address") {
+    GIVEN("A buffer with room for the deepest backtrace") {
+        auto buffer = std::string(panic_impl::BACKTRACE_SIZE + 1, '\0');
+
+        const auto size = panic_impl::write_backtrace(buffer);
+        auto text = std::string_view{buffer.data(), size};
+
+        THEN("It should be a header followed by numbered, fixed width frame addresses") {
+            if constexpr (panic_impl::BACKTRACE_DEPTH == 0) {
+                REQUIRE(size == 0);
+            } else {
+                const auto header = text.find(":\r\n");
+
+                REQUIRE(text.starts_with("backtrace"));
+                REQUIRE(header != std::string_view::npos);
+                text.remove_prefix(header + 3);
+
+                auto frames = std::size_t{0};
+
+                while (!text.empty()) {
+                    const auto line = text.substr(0, text.find("\r\n"));
+                    const auto prefix = "  #" + std::to_string(frames) + " 0x";
+                    const auto digits = line.substr(std::min(line.size(), prefix.size()));
+
+                    REQUIRE(line.starts_with(prefix));
+                    REQUIRE(digits.size() == 2 * sizeof(std::uintptr_t));
+                    REQUIRE(digits.find_first_not_of("0123456789abcdef") == std::string_view::npos);
+
+                    text.remove_prefix(std::min(text.size(), line.size() + 2));
+                    frames++;
+                }
+
+                REQUIRE(frames > 0);
+                REQUIRE(frames <= panic_impl::BACKTRACE_DEPTH);
+            }
+        }
+    }
+
+    GIVEN("A buffer too small for the backtrace") {
+        char buffer[12]{};
+        const auto size = panic_impl::write_backtrace(buffer);
+
+        THEN("It should be truncated to fit") {
+            if constexpr (panic_impl::BACKTRACE_DEPTH == 0) {
+                REQUIRE(size == 0);
+            } else {
+                REQUIRE(size == sizeof(buffer));
+                REQUIRE(std::string_view{buffer, size}.starts_with("backtrace"));
+            }
+        }
+    }
+}
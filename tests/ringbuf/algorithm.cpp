@@ -0,0 +1,105 @@
+/// Tests for the segmented algorithms.
+
+#include <array>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+#include "algorithm.hpp"
+#include "mirrored.hpp"
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity>
+using RingBuffer = core::ringbuf::RingBuffer<T, Capacity>;
+
+template<typename T>
+using MirroredRingBuffer = core::ringbuf::MirroredRingBuffer<T>;
+
+static_assert(core::ringbuf::SegmentedRange<RingBuffer<int, 8>>);
+static_assert(core::ringbuf::SegmentedRange<const RingBuffer<int, 8>>);
+static_assert(core::ringbuf::SegmentedRange<MirroredRingBuffer<int>>);
+static_assert(!core::ringbuf::SegmentedRange<std::vector<int>>);
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("Algorithms run over the segments of a RingBuffer") {
+    GIVEN("A RingBuffer whose contents may wrap the end of its storage") {
+        constexpr auto CAPACITY = 48;
+        auto buf = RingBuffer<uint32_t, CAPACITY>{};
+
+        auto offset = GENERATE(0, CAPACITY / 2, CAPACITY - 1);
+        for (auto i : std::views::iota(0, offset)) {
+            REQUIRE(buf.push((uint32_t)i));
+            REQUIRE(buf.pop());
+        }
+
+        auto count = GENERATE(0, 1, CAPACITY / 2, auto{CAPACITY});
+        auto expected = std::vector<uint32_t>{};
+
+        for (auto i : std::views::iota(0, count)) {
+            REQUIRE(buf.push((uint32_t)(i * 5)));
+            expected.push_back((uint32_t)(i * 5));
+        }
+
+        THEN("segments() should cover the contents in order") {
+            const auto segments = buf.segments();
+            const auto joined = std::views::join(std::array{segments.first, segments.second});
+
+            REQUIRE(segments.size() == expected.size());
+            REQUIRE(std::ranges::equal(joined, expected));
+        }
+
+        THEN("for_each() should visit every element in order") {
+            auto visited = std::vector<uint32_t>{};
+            core::ringbuf::for_each(buf, [&](const uint32_t value) { visited.push_back(value); });
+            REQUIRE(visited == expected);
+        }
+
+        THEN("copy() should copy every element in order") {
+            auto copied = std::vector<uint32_t>{};
+            core::ringbuf::copy(buf, std::back_inserter(copied));
+            REQUIRE(copied == expected);
+        }
+
+        THEN("accumulate() should match std::accumulate()") {
+            const auto sum = std::accumulate(expected.begin(), expected.end(), uint64_t{0});
+            REQUIRE(core::ringbuf::accumulate(buf, uint64_t{0}) == sum);
+            REQUIRE(accumulate(std::as_const(buf), uint64_t{0}) == sum);
+        }
+
+        THEN("count_if() should match std::ranges::count_if()") {
+            const auto even = [](const uint32_t value) { return value % 2 == 0; };
+            REQUIRE(core::ringbuf::count_if(buf, even) ==
+                    (size_t)std::ranges::count_if(expected, even));
+        }
+
+        WHEN("The contents are modified via fill()") {
+            core::ringbuf::fill(buf, uint32_t{7});
+
+            THEN("Every element should be replaced") {
+                REQUIRE(buf.size() == expected.size());
+                REQUIRE(std::ranges::all_of(buf, [](const uint32_t value) { return value == 7; }));
+            }
+        }
+    }
+
+    GIVEN("A RingBuffer of strings") {
+        auto buf = RingBuffer<std::string, 4>{};
+        REQUIRE(buf.push("a"));
+        REQUIRE(buf.pop());
+        REQUIRE(buf.push("b"));
+        REQUIRE(buf.push("c"));
+        REQUIRE(buf.push("d"));
+        REQUIRE(buf.push("e"));
+
+        THEN("accumulate() should concatenate them in order") {
+            REQUIRE(core::ringbuf::accumulate(buf, std::string{}) == "bcde");
+        }
+    }
+}
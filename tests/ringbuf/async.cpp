@@ -0,0 +1,250 @@
+/// Tests for the coroutine async_push() and async_pop() functions.
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <expected>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "mpmc.hpp"
+#include "ringbuf.hpp"
+#include "spsc.hpp"
+
+////////////////////////////////////////////////////////////////
+
+constexpr auto CAPACITY = size_t{8};
+
+using SpscRingBuffer = core::ringbuf::SpscRingBuffer<uint32_t, CAPACITY>;
+using MpmcRingBuffer = core::ringbuf::MpmcRingBuffer<uint32_t, CAPACITY>;
+
+using Error = core::ringbuf::Error;
+
+/// Coroutine which starts straight away and destroys itself when it finishes.
+struct Task {
+    struct promise_type {
+        auto get_return_object() noexcept -> Task { return {}; }
+        auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+        auto final_suspend() noexcept -> std::suspend_never { return {}; }
+        auto return_void() noexcept -> void {}
+        auto unhandled_exception() noexcept -> void { std::terminate(); }
+    };
+};
+
+template<typename Buffer>
+auto pop_one(Buffer& buf, std::expected<uint32_t, Error>& result, std::stop_token token = {})
+    -> Task {
+    result = co_await buf.async_pop(std::move(token));
+}
+
+template<typename Buffer>
+auto push_one(Buffer& buf, const uint32_t value, std::expected<void, Error>& result) -> Task {
+    result = co_await buf.async_push(value);
+}
+
+/// Pop count elements, adding them to sum, then increment done.
+template<typename Buffer>
+auto pop_many(Buffer& buf, const uint32_t count, std::atomic<uint64_t>& sum, std::atomic<int>& done)
+    -> Task {
+    for (auto i = uint32_t{0}; i < count; i++) {
+        const auto value = co_await buf.async_pop();
+        sum.fetch_add(*value, std::memory_order_relaxed);
+    }
+
+    done.fetch_add(1, std::memory_order_release);
+}
+
+////////////////////////////////////////////////////////////////
+
+template<typename Buffer>
+auto check_suspend() -> void {
+    auto buf = Buffer{};
+
+    WHEN("async_pop() is awaited on an empty buffer") {
+        auto result = std::expected<uint32_t, Error>{std::unexpected{Error::Empty()}};
+        pop_one(buf, result);
+
+        THEN("The coroutine should stay suspended until a push resumes it with the element") {
+            REQUIRE(result.error() == Error::Empty());
+
+            REQUIRE(buf.push_wait(42));
+            REQUIRE(result == 42);
+            REQUIRE(buf.empty());
+        }
+    }
+
+    WHEN("async_push() is awaited on a full buffer") {
+        for (auto i = uint32_t{0}; i < CAPACITY; i++) {
+            REQUIRE(buf.push_wait(i));
+        }
+
+        auto result = std::expected<void, Error>{std::unexpected{Error::Empty()}};
+        push_one(buf, 99, result);
+
+        THEN("The coroutine should stay suspended until a pop resumes it with the element pushed") {
+            REQUIRE(!result);
+
+            REQUIRE(buf.pop_wait() == 0);
+            REQUIRE(result);
+            REQUIRE(buf.full());
+        }
+    }
+
+    WHEN("The awaited operations can proceed straight away") {
+        auto pushed = std::expected<void, Error>{std::unexpected{Error::Empty()}};
+        auto popped = std::expected<uint32_t, Error>{std::unexpected{Error::Empty()}};
+
+        push_one(buf, 7, pushed);
+        pop_one(buf, popped);
+
+        THEN("They should complete without suspending") {
+            REQUIRE(pushed);
+            REQUIRE(popped == 7);
+        }
+    }
+}
+
+template<typename Buffer>
+auto check_close_and_cancel() -> void {
+    auto buf = Buffer{};
+
+    WHEN("A suspended pop's buffer is closed") {
+        auto result = std::expected<uint32_t, Error>{};
+        pop_one(buf, result);
+        buf.close();
+
+        THEN("It should be resumed with Closed") {
+            REQUIRE(result.error() == Error::Closed());
+        }
+    }
+
+    WHEN("A suspended push's buffer is closed") {
+        for (auto i = uint32_t{0}; i < CAPACITY; i++) {
+            REQUIRE(buf.push_wait(i));
+        }
+
+        auto result = std::expected<void, Error>{};
+        push_one(buf, 99, result);
+        buf.close();
+
+        THEN("It should be resumed with Closed and the buffer should still drain") {
+            REQUIRE(result.error() == Error::Closed());
+            REQUIRE(buf.pop_wait() == 0);
+        }
+    }
+
+    WHEN("A stop is requested for a suspended pop") {
+        auto source = std::stop_source{};
+        auto result = std::expected<uint32_t, Error>{};
+        pop_one(buf, result, source.get_token());
+
+        source.request_stop();
+
+        THEN("It should be resumed with Cancelled and no longer take elements") {
+            REQUIRE(result.error() == Error::Cancelled());
+
+            REQUIRE(buf.push_wait(1));
+            REQUIRE(buf.size() == 1);
+        }
+    }
+
+    WHEN("A stop was requested before the pop was awaited") {
+        auto source = std::stop_source{};
+        auto result = std::expected<uint32_t, Error>{};
+
+        source.request_stop();
+        pop_one(buf, result, source.get_token());
+
+        THEN("It should complete with Cancelled") {
+            REQUIRE(result.error() == Error::Cancelled());
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("async_push() and async_pop() suspend until they can proceed") {
+    GIVEN("An SpscRingBuffer") {
+        check_suspend<SpscRingBuffer>();
+    }
+
+    GIVEN("An MpmcRingBuffer") {
+        check_suspend<MpmcRingBuffer>();
+    }
+}
+
+SCENARIO("Suspended coroutines are resumed by close() and stop requests") {
+    GIVEN("An SpscRingBuffer") {
+        check_close_and_cancel<SpscRingBuffer>();
+    }
+
+    GIVEN("An MpmcRingBuffer") {
+        check_close_and_cancel<MpmcRingBuffer>();
+    }
+}
+
+SCENARIO("One thread multiplexes many queue endpoints") {
+    GIVEN("Many SpscRingBuffers, each with a suspended consumer coroutine") {
+        constexpr auto ENDPOINTS = size_t{1000};
+
+        auto buffers = std::vector<SpscRingBuffer>(ENDPOINTS);
+        auto results = std::vector<std::expected<uint32_t, Error>>(ENDPOINTS);
+
+        for (auto i = size_t{0}; i < ENDPOINTS; i++) {
+            pop_one(buffers[i], results[i]);
+        }
+
+        WHEN("An element is pushed to each buffer") {
+            for (auto i = size_t{0}; i < ENDPOINTS; i++) {
+                REQUIRE(buffers[i].push((uint32_t)i));
+            }
+
+            THEN("Each coroutine should have received its element") {
+                auto all_received = true;
+                for (auto i = size_t{0}; i < ENDPOINTS; i++) {
+                    all_received = all_received && results[i] == i;
+                }
+
+                REQUIRE(all_received);
+            }
+        }
+    }
+}
+
+SCENARIO("MpmcRingBuffer coroutine consumers fed by several producer threads") {
+    GIVEN("An MpmcRingBuffer with several consumer coroutines") {
+        constexpr auto THREADS = size_t{4};
+        constexpr auto COUNT = uint32_t{10'000};
+
+        auto buf = MpmcRingBuffer{};
+        auto sum = std::atomic<uint64_t>{0};
+        auto done = std::atomic<int>{0};
+
+        for (auto t = size_t{0}; t < THREADS; t++) {
+            pop_many(buf, COUNT, sum, done);
+        }
+
+        WHEN("Each producer thread pushes a sequence") {
+            auto producers = std::vector<std::thread>();
+
+            for (auto t = size_t{0}; t < THREADS; t++) {
+                producers.emplace_back([&buf] {
+                    for (auto i = uint32_t{1}; i <= COUNT; i++) {
+                        static_cast<void>(buf.push_wait(i));
+                    }
+                });
+            }
+
+            for (auto& thread : producers) thread.join();
+
+            THEN("The coroutines should receive every element exactly once") {
+                REQUIRE(done.load(std::memory_order_acquire) == (int)THREADS);
+                REQUIRE(sum.load() == THREADS * (uint64_t{COUNT} * (COUNT + 1) / 2));
+                REQUIRE(buf.empty());
+            }
+        }
+    }
+}
@@ -0,0 +1,138 @@
+/// Tests for using RingBuffer in constant expressions.
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity>
+using RingBuffer = core::ringbuf::RingBuffer<T, Capacity>;
+
+using Error = core::ringbuf::Error;
+
+////////////////////////////////////////////////////////////////
+
+/// Push past capacity and pop past empty, checking each result.
+template<size_t Capacity>
+consteval auto round_trip() -> bool {
+    auto buf = RingBuffer<int, Capacity>{};
+
+    for (auto i = 0; i < static_cast<int>(Capacity); i++) {
+        if (!buf.push(i)) {
+            return false;
+        }
+    }
+
+    if (buf.push(99).error() != Error::Full() || !buf.full() || buf.free() != 0) {
+        return false;
+    }
+
+    for (auto i = 0; i < static_cast<int>(Capacity); i++) {
+        if (buf.pop() != i) {
+            return false;
+        }
+    }
+
+    return buf.pop().error() == Error::Empty() && buf.empty();
+}
+
+static_assert(round_trip<8>());
+static_assert(round_trip<5>());
+
+/// Errors whose formats take no arguments have their messages resolved at compile time.
+static_assert(Error::CONSTANT_MESSAGES);
+static_assert(Error{Error::Full()}.message() == "Buffer full");
+static_assert(Error{Error::Contended()}.message() == "Lost a race with another thread");
+
+/// Bulk transfers which wrap around the end of the storage.
+consteval auto wrapped_buffers() -> bool {
+    auto buf = RingBuffer<int, 5>{};
+    const auto input = std::array{1, 2, 3, 4};
+    auto output = std::array<int, 4>{};
+
+    static_cast<void>(buf.push_buffer(std::span(input).first(3)));
+    static_cast<void>(buf.consume(3));
+    static_cast<void>(buf.push_buffer(input));
+    static_cast<void>(buf.pop_buffer(output));
+
+    return output == input && buf.empty() && buf.pop_buffer(output).error() == Error::Empty();
+}
+
+static_assert(wrapped_buffers());
+
+/// Iteration, batch callbacks, copies and clearing.
+consteval auto whole_container() -> bool {
+    auto buf = RingBuffer<int, 4>{};
+    auto next = 1;
+
+    static_cast<void>(buf.fill(4, [&] { return next++; }));
+    static_cast<void>(buf.pop());
+    static_cast<void>(buf.emplace(5));
+
+    auto sum = 0;
+    for (const auto value : buf) {
+        sum += value;
+    }
+
+    const auto copy = buf;
+    auto drained = 0;
+    buf.drain_all([&](const int value) { drained += value; });
+    buf.clear();
+
+    return sum == 14 && drained == 14 && copy.size() == 4 && buf.empty();
+}
+
+static_assert(whole_container());
+
+////////////////////////////////////////////////////////////////
+
+/// Sliding window of the last 4 samples, precomputed into a table of their sums.
+constexpr auto WINDOW_SUMS = [] {
+    constexpr auto SAMPLES = std::array<uint8_t, 8>{3, 1, 4, 1, 5, 9, 2, 6};
+
+    auto window = RingBuffer<uint8_t, 4>{};
+    auto sums = std::array<int, SAMPLES.size()>{};
+    auto sum = 0;
+
+    for (auto i = size_t{0}; i < SAMPLES.size(); i++) {
+        if (window.full()) {
+            sum -= *window.pop();
+        }
+
+        static_cast<void>(window.push(SAMPLES[i]));
+        sum += SAMPLES[i];
+        sums[i] = sum;
+    }
+
+    return sums;
+}();
+
+SCENARIO("A RingBuffer can build tables at compile time") {
+    GIVEN("A table of sliding window sums built in a constant expression") {
+        THEN("It should hold the sum of the last 4 samples at each point") {
+            REQUIRE(WINDOW_SUMS == std::array{3, 4, 8, 9, 11, 19, 17, 22});
+        }
+    }
+
+    GIVEN("A RingBuffer built in a constant expression") {
+        constexpr auto BUF = [] {
+            auto buf = RingBuffer<int, 4>{};
+            static_cast<void>(buf.push_buffer(std::array{1, 2, 3}));
+            static_cast<void>(buf.pop());
+            return buf;
+        }();
+
+        THEN("It should be usable at runtime") {
+            auto copy = BUF;
+
+            REQUIRE(copy.size() == 2);
+            REQUIRE(copy.pop() == 2);
+            REQUIRE(copy.pop() == 3);
+        }
+    }
+}
@@ -0,0 +1,135 @@
+/// Tests for the bulk copy path used by push_buffer() and pop_buffer().
+
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+#include "copy.hpp"
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T>
+using DynamicRingBuffer = core::ringbuf::DynamicRingBuffer<T>;
+
+constexpr auto NON_TEMPORAL_THRESHOLD = core::ringbuf::NON_TEMPORAL_THRESHOLD;
+
+/// Fill a buffer with a pattern which doesn't repeat at any power of two.
+auto pattern(const size_t size) -> std::vector<uint8_t> {
+    auto data = std::vector<uint8_t>(size);
+
+    for (auto i : std::views::iota(size_t{0}, size)) {
+        data[i] = (uint8_t)((i * 7) % 251);
+    }
+
+    return data;
+}
+
+/// Move the indices of an empty buffer so the next write of size bytes straddles the wrap.
+auto straddle_wrap(DynamicRingBuffer<uint8_t>& buf, const size_t size) -> void {
+    const auto offset = buf.capacity() - (size / 2);
+
+    static_cast<void>(buf.commit_write(offset));
+    static_cast<void>(buf.consume(offset));
+}
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("copy_elements() copies every byte") {
+    GIVEN("Source and destination buffers around the non-temporal threshold") {
+        auto size = GENERATE(size_t{0},
+                             size_t{1},
+                             size_t{31},
+                             NON_TEMPORAL_THRESHOLD - 1,
+                             auto{NON_TEMPORAL_THRESHOLD},
+                             NON_TEMPORAL_THRESHOLD + 97);
+        auto misalignment = GENERATE(size_t{0}, size_t{1}, size_t{13});
+
+        const auto source = pattern(size + misalignment);
+        auto destination = std::vector<uint8_t>(size + misalignment + 1, 0xFF);
+
+        WHEN("The source is copied to a misaligned destination") {
+            core::ringbuf::copy_elements(std::span(source).subspan(misalignment),
+                                         std::next(destination.data(), misalignment));
+
+            THEN("The destination should match the source") {
+                REQUIRE(std::ranges::equal(std::span(destination).subspan(misalignment, size),
+                                           std::span(source).subspan(misalignment)));
+            }
+
+            THEN("Nothing outside the destination should be written") {
+                REQUIRE(destination.back() == 0xFF);
+            }
+        }
+    }
+
+    GIVEN("A type which isn't trivially copyable") {
+        const auto source = std::vector<std::string>{"a", "b", "c"};
+        auto destination = std::vector<std::string>(3);
+
+        THEN("Each element should be copied") {
+            core::ringbuf::copy_elements(std::span(source), destination.data());
+            REQUIRE(destination == source);
+        }
+    }
+}
+
+SCENARIO("stream_bytes() copies every byte however small the copy") {
+    GIVEN("Copies smaller than a vector to a misaligned destination") {
+        // As happens when NON_TEMPORAL_THRESHOLD is tuned below the vector width.
+        auto size = GENERATE(size_t{0}, size_t{1}, size_t{7}, size_t{15}, size_t{100});
+        auto misalignment = GENERATE(size_t{1}, size_t{13}, size_t{31});
+
+        const auto source = pattern(size);
+        auto destination = std::vector<uint8_t>(size + misalignment + 1, 0xFF);
+
+        WHEN("The source is streamed to the destination") {
+            core::ringbuf::copy_impl::stream_bytes(
+                reinterpret_cast<std::byte*>(std::next(destination.data(), misalignment)),
+                reinterpret_cast<const std::byte*>(source.data()),
+                size);
+
+            THEN("Only the destination should be written, and it should match the source") {
+                REQUIRE(std::ranges::equal(std::span(destination).subspan(misalignment, size),
+                                           source));
+                REQUIRE(destination.back() == 0xFF);
+            }
+        }
+    }
+}
+
+SCENARIO("Bulk transfers across the wrap") {
+    GIVEN("A buffer with its indices positioned so a transfer straddles the wrap") {
+        auto size = GENERATE(size_t{1},
+                             size_t{2},
+                             size_t{63},
+                             size_t{4096},
+                             size_t{65536},
+                             size_t{1024 * 1024});
+
+        auto buf = DynamicRingBuffer<uint8_t>::create(2 * size);
+        REQUIRE(buf.has_value());
+        straddle_wrap(*buf, size);
+
+        const auto write_data = pattern(size);
+
+        WHEN("Data is pushed via push_buffer()") {
+            REQUIRE(buf->push_buffer(write_data));
+            REQUIRE(buf->size() == size);
+
+            THEN("Reading it back via pop_buffer() should return the same data") {
+                auto read_data = std::vector<uint8_t>(size);
+                REQUIRE(buf->pop_buffer(read_data));
+                REQUIRE(read_data == write_data);
+                REQUIRE(buf->empty());
+            }
+
+            THEN("Iterating should visit the same data") {
+                REQUIRE(std::ranges::equal(*buf, write_data));
+            }
+        }
+    }
+}
@@ -0,0 +1,162 @@
+/// Tests for WorkStealingDeque.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+#include "deque.hpp"
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T>
+using WorkStealingDeque = core::ringbuf::WorkStealingDeque<T>;
+
+using Error = core::ringbuf::Error;
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("WorkStealingDeque is a stack for its owner and a queue for thieves") {
+    GIVEN("An empty WorkStealingDeque") {
+        auto deque = std::move(*WorkStealingDeque<uint32_t>::create(8));
+
+        THEN("Popping and stealing should fail with Empty") {
+            REQUIRE(deque.empty());
+            REQUIRE(deque.pop().error() == Error::Empty());
+            REQUIRE(deque.steal().error() == Error::Empty());
+        }
+
+        WHEN("Several elements are pushed") {
+            for (auto i : std::views::iota(uint32_t{0}, uint32_t{5})) {
+                REQUIRE(deque.push(i));
+            }
+
+            THEN("The owner should pop them newest first") {
+                for (auto i : std::views::iota(uint32_t{0}, uint32_t{5}) | std::views::reverse) {
+                    REQUIRE(deque.pop() == i);
+                }
+
+                REQUIRE(deque.pop().error() == Error::Empty());
+            }
+
+            THEN("Thieves should steal them oldest first") {
+                for (auto i : std::views::iota(uint32_t{0}, uint32_t{5})) {
+                    REQUIRE(deque.steal() == i);
+                }
+
+                REQUIRE(deque.steal().error() == Error::Empty());
+            }
+
+            THEN("Popping and stealing should meet in the middle") {
+                REQUIRE(deque.steal() == 0);
+                REQUIRE(deque.pop() == 4);
+                REQUIRE(deque.steal() == 1);
+                REQUIRE(deque.pop() == 3);
+                REQUIRE(deque.pop() == 2);
+                REQUIRE(deque.empty());
+                REQUIRE(deque.steal().error() == Error::Empty());
+            }
+        }
+
+        WHEN("More elements are pushed than it has space for") {
+            const auto offset = GENERATE(0U, 3U, 8U);
+            for (auto i : std::views::iota(0U, offset)) {
+                REQUIRE(deque.push(i));
+                REQUIRE(deque.steal() == i);
+            }
+
+            for (auto i : std::views::iota(uint32_t{0}, uint32_t{100})) {
+                REQUIRE(deque.push(i));
+            }
+
+            THEN("It should grow and keep every element in order") {
+                REQUIRE(deque.capacity() >= 100);
+                REQUIRE(deque.size() == 100);
+
+                for (auto i : std::views::iota(uint32_t{0}, uint32_t{50})) {
+                    REQUIRE(deque.steal() == i);
+                }
+
+                for (auto i : std::views::iota(uint32_t{50}, uint32_t{100}) | std::views::reverse) {
+                    REQUIRE(deque.pop() == i);
+                }
+            }
+        }
+
+        WHEN("It's moved from") {
+            REQUIRE(deque.push(7));
+            auto moved = std::move(deque);
+
+            THEN("The new deque should hold its elements and the old one should be empty") {
+                REQUIRE(moved.capacity() >= 8);
+                REQUIRE(moved.pop() == 7);
+
+                REQUIRE(deque.empty());
+                REQUIRE(deque.size() == 0);
+                REQUIRE(deque.capacity() == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("WorkStealingDeque hands each element to exactly one thread") {
+    GIVEN("An owner pushing and popping while several thieves steal") {
+        constexpr auto THIEVES = 3;
+        constexpr auto COUNT = uint32_t{50'000};
+
+        auto deque = std::move(*WorkStealingDeque<uint32_t>::create(16));
+        auto taken = std::vector<std::vector<uint32_t>>(THIEVES + 1);
+        auto remaining = std::atomic<uint32_t>{COUNT};
+
+        {
+            auto threads = std::vector<std::jthread>{};
+
+            for (auto t : std::views::iota(1, THIEVES + 1)) {
+                threads.emplace_back([&, t] {
+                    while (remaining.load(std::memory_order_relaxed) > 0) {
+                        if (const auto value = deque.steal()) {
+                            remaining.fetch_sub(1, std::memory_order_relaxed);
+                            taken[t].push_back(*value);
+                        }
+                    }
+                });
+            }
+
+            // Pop every few pushes, so the owner races thieves for the last element too.
+            for (auto i : std::views::iota(uint32_t{0}, COUNT)) {
+                REQUIRE(deque.push(i));
+
+                if (i % 3 == 0) {
+                    if (const auto value = deque.pop()) {
+                        remaining.fetch_sub(1, std::memory_order_relaxed);
+                        taken[0].push_back(*value);
+                    }
+                }
+            }
+
+            while (remaining.load(std::memory_order_relaxed) > 0) {
+                if (const auto value = deque.pop()) {
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                    taken[0].push_back(*value);
+                }
+            }
+        }
+
+        THEN("Every element should be taken exactly once") {
+            auto seen = std::vector<uint8_t>(COUNT);
+
+            for (const auto& values : taken) {
+                for (auto value : values) seen[value]++;
+            }
+
+            REQUIRE(std::ranges::all_of(seen, [](const uint8_t count) { return count == 1; }));
+            REQUIRE(deque.empty());
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/// Tests for runtime sized RingBuffers.
+
+#include <array>
+#include <limits>
+#include <memory_resource>
+#include <ranges>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+#include "page_resource.hpp"
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T>
+using DynamicRingBuffer = core::ringbuf::DynamicRingBuffer<T>;
+
+using PageResource = core::ringbuf::PageResource;
+using Error = core::ringbuf::Error;
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("DynamicRingBuffer creation") {
+    GIVEN("A capacity of zero") {
+        THEN("Creating a buffer should return an error") {
+            auto buf = DynamicRingBuffer<uint8_t>::create(0);
+            REQUIRE(!buf.has_value());
+            REQUIRE(buf.error() == Error::Alloc());
+        }
+    }
+
+    GIVEN("A memory resource that can't satisfy the allocation") {
+        auto storage = std::array<std::byte, 64>{};
+        auto resource = std::pmr::monotonic_buffer_resource(
+            storage.data(), storage.size(), std::pmr::null_memory_resource());
+
+        THEN("Creating a buffer should return an error") {
+            auto buf = DynamicRingBuffer<uint32_t>::create(1024, &resource);
+            REQUIRE(!buf.has_value());
+            REQUIRE(buf.error() == Error::Alloc());
+        }
+    }
+
+    GIVEN("A capacity whose size in bytes doesn't fit in a size_t") {
+        constexpr auto CAPACITY = (std::numeric_limits<size_t>::max() / sizeof(uint32_t)) + 2;
+
+        // Were the size to wrap, the few bytes left would easily fit.
+        auto storage = std::array<std::byte, 64>{};
+        auto resource = std::pmr::monotonic_buffer_resource(
+            storage.data(), storage.size(), std::pmr::null_memory_resource());
+
+        THEN("Creating a buffer should return an error") {
+            auto buf = DynamicRingBuffer<uint32_t>::create(CAPACITY, &resource);
+            REQUIRE(!buf.has_value());
+            REQUIRE(buf.error() == Error::Alloc());
+        }
+    }
+
+    GIVEN("A capacity") {
+        auto capacity = GENERATE(size_t{1}, size_t{100}, size_t{4096});
+
+        WHEN("A buffer is created") {
+            auto buf = DynamicRingBuffer<uint32_t>::create(capacity);
+            REQUIRE(buf.has_value());
+
+            THEN("It should be empty with the given capacity") {
+                REQUIRE(buf->capacity() == capacity);
+                REQUIRE(buf->empty());
+                REQUIRE(buf->free() == capacity);
+            }
+
+            AND_WHEN("The buffer is moved") {
+                auto moved = std::move(*buf);
+
+                THEN("The new buffer should own the storage") {
+                    REQUIRE(moved.capacity() == capacity);
+                    REQUIRE(moved.push(3));
+                    REQUIRE(moved.pop() == 3u);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("DynamicRingBuffer properties") {
+    GIVEN("A DynamicRingBuffer from a memory resource") {
+        constexpr auto CAPACITY = size_t{100};
+
+        auto page_resource = PageResource();
+        auto huge_page_resource = PageResource({.huge_pages = true});
+        auto numa_resource = PageResource({.numa_node = 0});
+        auto pool_resource = std::pmr::unsynchronized_pool_resource();
+
+        auto* resource = GENERATE_REF(static_cast<std::pmr::memory_resource*>(&page_resource),
+                                      static_cast<std::pmr::memory_resource*>(&huge_page_resource),
+                                      static_cast<std::pmr::memory_resource*>(&numa_resource),
+                                      static_cast<std::pmr::memory_resource*>(&pool_resource));
+
+        auto buf = std::move(DynamicRingBuffer<uint32_t>::create(CAPACITY, resource).value());
+
+        auto offset = GENERATE(size_t{0}, CAPACITY / 2, CAPACITY - 1, CAPACITY + 10);
+        for (auto i : std::views::iota(size_t{0}, offset)) {
+            REQUIRE(buf.push((uint32_t)i));
+            REQUIRE(buf.pop());
+        }
+
+        WHEN("The buffer is filled") {
+            auto write_data = std::vector<uint32_t>(CAPACITY);
+            for (auto i : std::views::iota(size_t{0}, CAPACITY)) {
+                write_data[i] = (uint32_t)i;
+            }
+
+            REQUIRE(buf.push_buffer(write_data));
+
+            THEN("It should be full") {
+                REQUIRE(buf.full());
+                REQUIRE(buf.size() == CAPACITY);
+                REQUIRE(buf.free() == 0);
+
+                auto result = buf.push(0);
+                REQUIRE(!result.has_value());
+                REQUIRE(result.error() == Error::Full());
+            }
+
+            THEN("It should be usable as a random access range") {
+                REQUIRE(std::ranges::equal(buf, write_data));
+                REQUIRE(std::ranges::size(buf) == CAPACITY);
+                REQUIRE(buf.begin()[CAPACITY / 2] == CAPACITY / 2);
+            }
+
+            THEN("The data should be read in the order it was written") {
+                for (auto value : write_data) {
+                    REQUIRE(buf.pop() == value);
+                }
+
+                REQUIRE(buf.empty());
+            }
+        }
+    }
+}
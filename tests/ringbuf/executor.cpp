@@ -0,0 +1,161 @@
+/// Tests for ThreadPool.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+#include "executor.hpp"
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+using ThreadPool = core::ringbuf::ThreadPool;
+using Error = core::ringbuf::Error;
+
+////////////////////////////////////////////////////////////////
+
+/// Sum [first, last) by splitting it in half until the pieces are small, like a parallel for.
+auto parallel_sum(ThreadPool& pool,
+                  std::atomic<uint64_t>& sum,
+                  const uint64_t first,
+                  const uint64_t last) -> void {
+    if (last - first <= 64) {
+        auto local = uint64_t{0};
+        for (auto i = first; i < last; i++) local += i;
+
+        sum.fetch_add(local, std::memory_order_relaxed);
+        return;
+    }
+
+    const auto middle = first + ((last - first) / 2);
+    const auto upper = [&pool, &sum, middle, last] { parallel_sum(pool, sum, middle, last); };
+
+    if (!pool.submit(upper)) {
+        upper();
+    }
+
+    parallel_sum(pool, sum, first, middle);
+}
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("A ThreadPool runs every task submitted to it") {
+    GIVEN("A ThreadPool") {
+        const auto workers = GENERATE(size_t{1}, size_t{4});
+        auto pool = std::move(*ThreadPool::create(workers));
+
+        REQUIRE(pool->workers() == workers);
+
+        WHEN("Tasks are submitted from outside the pool") {
+            constexpr auto COUNT = 500;
+            auto ran = std::atomic<int>{};
+
+            for (auto i = 0; i < COUNT; i++) {
+                // The shared queue may briefly fill up if the workers fall behind.
+                while (true) {
+                    const auto result = pool->submit([&] { ran.fetch_add(1); });
+                    if (result) break;
+
+                    REQUIRE(result.error() == Error::Full());
+                    std::this_thread::yield();
+                }
+            }
+
+            pool.reset();
+
+            THEN("They should all have run once the pool is destroyed") {
+                REQUIRE(ran.load() == COUNT);
+            }
+        }
+
+        WHEN("Tasks submit further tasks from inside the pool") {
+            constexpr auto LAST = uint64_t{100'000};
+            auto sum = std::atomic<uint64_t>{};
+
+            auto* const raw = pool.get();
+
+            REQUIRE(pool->submit([raw, &sum] { parallel_sum(*raw, sum, 0, LAST); }));
+            pool.reset();
+
+            THEN("Every piece of work should have run") {
+                REQUIRE(sum.load() == (LAST * (LAST - 1)) / 2);
+            }
+        }
+    }
+}
+
+SCENARIO("A ThreadPool spreads work across its workers") {
+    GIVEN("A ThreadPool with several workers and a task which spawns many slow tasks") {
+        constexpr auto WORKERS = size_t{4};
+        constexpr auto TASKS = size_t{64};
+
+        auto pool = std::move(*ThreadPool::create(WORKERS));
+        auto* const raw = pool.get();
+
+        auto mutex = std::mutex{};
+        auto ids = std::vector<std::thread::id>{};
+        auto rejected = std::atomic<int>{};
+
+        const auto task = [&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+            const auto lock = std::scoped_lock{mutex};
+            ids.push_back(std::this_thread::get_id());
+        };
+
+        REQUIRE(pool->submit([&] {
+            for (auto i = size_t{0}; i < TASKS; i++) {
+                if (!raw->submit(task)) rejected++;
+            }
+        }));
+
+        pool.reset();
+
+        THEN("Idle workers should have stolen some of them") {
+            std::ranges::sort(ids);
+            const auto duplicates = std::ranges::unique(ids);
+
+            REQUIRE(rejected.load() == 0);
+            REQUIRE(ids.size() == TASKS);
+            REQUIRE(duplicates.begin() - ids.begin() > 1);
+        }
+    }
+}
+
+SCENARIO("A ThreadPool wakes a parked worker for each task") {
+    GIVEN("A ThreadPool whose workers have had time to park") {
+        constexpr auto COUNT = 20;
+
+        auto pool = std::move(*ThreadPool::create(4));
+        auto ran = std::atomic<int>{};
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+        WHEN("Tasks are submitted one at a time, each after the last has run") {
+            auto prompt = 0;
+
+            for (auto i = 0; i < COUNT; i++) {
+                REQUIRE(pool->submit([&] { ran.fetch_add(1); }));
+
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+                while (ran.load() == i && std::chrono::steady_clock::now() < deadline) {
+                    std::this_thread::yield();
+                }
+
+                prompt += ran.load() == i + 1 ? 1 : 0;
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+
+            THEN("Each should run without waiting for the pool to be destroyed") {
+                REQUIRE(prompt == COUNT);
+            }
+        }
+    }
+}
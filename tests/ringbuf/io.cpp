@@ -0,0 +1,175 @@
+/// Tests for read_from() and write_to().
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+#include "io.hpp"
+#include "mirrored.hpp"
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity>
+using RingBuffer = core::ringbuf::RingBuffer<T, Capacity>;
+
+template<typename T>
+using MirroredRingBuffer = core::ringbuf::MirroredRingBuffer<T>;
+
+using Error = core::ringbuf::Error;
+
+////////////////////////////////////////////////////////////////
+
+/// Non-blocking pipe which closes both ends when destroyed.
+struct Pipe {
+    Pipe() {
+        REQUIRE(pipe(this->fds.data()) == 0);
+        REQUIRE(fcntl(this->read_end(), F_SETFL, O_NONBLOCK) == 0);
+        REQUIRE(fcntl(this->write_end(), F_SETFL, O_NONBLOCK) == 0);
+    }
+
+    Pipe(const Pipe& other) = delete;
+    auto operator=(const Pipe& other) -> Pipe& = delete;
+
+    ~Pipe() {
+        for (const auto fd : this->fds) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    auto read_end() const -> int { return this->fds[0]; }
+    auto write_end() const -> int { return this->fds[1]; }
+
+    auto close_write_end() -> void {
+        close(this->fds[1]);
+        this->fds[1] = -1;
+    }
+
+    std::array<int, 2> fds{-1, -1};
+};
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("Bytes are moved between a RingBuffer and a file descriptor") {
+    constexpr auto CAPACITY = size_t{16};
+
+    GIVEN("A RingBuffer whose contents wrap around the end of its storage") {
+        auto buf = RingBuffer<uint8_t, CAPACITY>{};
+        auto pipe = Pipe{};
+
+        const auto offset = GENERATE(size_t{0}, CAPACITY / 2, CAPACITY - 1);
+        for (auto i = size_t{0}; i < offset; i++) {
+            REQUIRE(buf.push(0));
+            REQUIRE(buf.pop());
+        }
+
+        auto data = std::array<uint8_t, CAPACITY>{};
+        std::iota(data.begin(), data.end(), uint8_t{1});
+
+        WHEN("It's filled from the file descriptor") {
+            REQUIRE(write(pipe.write_end(), data.data(), data.size()) == ssize_t{CAPACITY});
+
+            const auto result = core::ringbuf::read_from(buf, pipe.read_end());
+
+            THEN("It should hold everything written, in order") {
+                REQUIRE(result == CAPACITY);
+                REQUIRE(buf.full());
+
+                for (const auto byte : data) {
+                    REQUIRE(buf.pop() == byte);
+                }
+            }
+
+            AND_WHEN("It's written back to another file descriptor") {
+                auto other = Pipe{};
+                const auto result = core::ringbuf::write_to(buf, other.write_end());
+
+                THEN("The bytes should be written in order and removed from the buffer") {
+                    auto output = std::array<uint8_t, CAPACITY>{};
+
+                    const auto received = read(other.read_end(), output.data(), output.size());
+
+                    REQUIRE(result == CAPACITY);
+                    REQUIRE(buf.empty());
+                    REQUIRE(received == ssize_t{CAPACITY});
+                    REQUIRE(output == data);
+                }
+            }
+        }
+
+        WHEN("The file descriptor has nothing to read") {
+            THEN("Nothing should be read") {
+                REQUIRE(core::ringbuf::read_from(buf, pipe.read_end()) == 0);
+                REQUIRE(buf.empty());
+            }
+        }
+
+        WHEN("The file descriptor has been closed by the writer") {
+            pipe.close_write_end();
+
+            THEN("Reading should fail with Closed") {
+                REQUIRE(core::ringbuf::read_from(buf, pipe.read_end()).error() == Error::Closed());
+            }
+        }
+    }
+
+    GIVEN("A full RingBuffer") {
+        auto buf = RingBuffer<uint8_t, CAPACITY>{};
+        auto pipe = Pipe{};
+
+        while (buf.push(0)) continue;
+
+        THEN("Reading into it should fail with Full") {
+            REQUIRE(core::ringbuf::read_from(buf, pipe.read_end()).error() == Error::Full());
+        }
+    }
+
+    GIVEN("An empty RingBuffer") {
+        auto buf = RingBuffer<uint8_t, CAPACITY>{};
+        auto pipe = Pipe{};
+
+        THEN("Writing from it should fail with Empty") {
+            REQUIRE(core::ringbuf::write_to(buf, pipe.write_end()).error() == Error::Empty());
+        }
+    }
+
+    GIVEN("An invalid file descriptor") {
+        auto buf = RingBuffer<uint8_t, CAPACITY>{};
+
+        THEN("Reading should fail with Io and leave errno set") {
+            REQUIRE(core::ringbuf::read_from(buf, -1).error() == Error::Io());
+            REQUIRE(errno == EBADF);
+        }
+    }
+}
+
+SCENARIO("Bytes are moved between a MirroredRingBuffer and a file descriptor") {
+    GIVEN("A MirroredRingBuffer") {
+        auto buf = std::move(*MirroredRingBuffer<std::byte>::create(1));
+        auto pipe = Pipe{};
+
+        const auto data = std::vector<uint8_t>(100, 7);
+        REQUIRE(write(pipe.write_end(), data.data(), data.size()) == 100);
+
+        WHEN("It's filled from the file descriptor and written back") {
+            REQUIRE(core::ringbuf::read_from(buf, pipe.read_end()) == 100);
+            REQUIRE(core::ringbuf::write_to(buf, pipe.write_end()) == 100);
+
+            THEN("The bytes should have made the round trip") {
+                auto output = std::vector<uint8_t>(100);
+
+                REQUIRE(buf.empty());
+                REQUIRE(read(pipe.read_end(), output.data(), output.size()) == 100);
+                REQUIRE(output == data);
+            }
+        }
+    }
+}
@@ -0,0 +1,136 @@
+/// Tests for MirroredRingBuffer.
+
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+#include "mirrored.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T>
+using MirroredRingBuffer = core::ringbuf::MirroredRingBuffer<T>;
+
+using Error = core::ringbuf::Error;
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("MirroredRingBuffer creation") {
+    GIVEN("A requested capacity") {
+        auto requested = GENERATE(size_t{0}, size_t{1}, size_t{1000}, size_t{1 << 20});
+
+        WHEN("A buffer is created") {
+            auto buf = MirroredRingBuffer<uint32_t>::create(requested);
+            REQUIRE(buf.has_value());
+
+            THEN("It should be empty with at least the requested capacity") {
+                REQUIRE(buf->empty());
+                REQUIRE(buf->capacity() >= requested);
+                REQUIRE(buf->free() == buf->capacity());
+            }
+
+            THEN("The capacity should be a whole number of pages") {
+                const auto page_size = core::ringbuf::mirror_impl::page_size();
+                REQUIRE((buf->capacity() * sizeof(uint32_t)) % page_size == 0);
+            }
+
+            AND_WHEN("The buffer is moved") {
+                const auto capacity = buf->capacity();
+                auto moved = std::move(*buf);
+
+                THEN("The new buffer should own the storage") {
+                    REQUIRE(moved.capacity() == capacity);
+                    REQUIRE(moved.push(1));
+                    REQUIRE(moved.pop() == 1u);
+                }
+            }
+        }
+    }
+
+    GIVEN("A requested capacity too large to map twice") {
+        const auto max = std::numeric_limits<size_t>::max();
+        auto requested = GENERATE_COPY(max, max / sizeof(uint32_t), max / 2 / sizeof(uint32_t));
+
+        THEN("Creating a buffer should fail with Alloc") {
+            REQUIRE(MirroredRingBuffer<uint32_t>::create(requested).error() == Error::Alloc());
+        }
+    }
+}
+
+SCENARIO("MirroredRingBuffer ranges are contiguous across the wrap") {
+    GIVEN("A MirroredRingBuffer with its pointers near the end of the storage") {
+        auto buf = std::move(MirroredRingBuffer<uint32_t>::create(1024).value());
+        const auto capacity = buf.capacity();
+
+        auto remaining = GENERATE(size_t{1}, size_t{7}, size_t{100});
+        auto offset = capacity - remaining;
+
+        auto filler = std::vector<uint32_t>(offset);
+        REQUIRE(buf.push_buffer(filler));
+        REQUIRE(buf.consume(offset));
+        REQUIRE(buf.empty());
+
+        WHEN("Data is pushed that wraps the end of the storage") {
+            auto write_data = std::vector<uint32_t>(remaining * 2);
+            std::iota(write_data.begin(), write_data.end(), uint32_t{0});
+            REQUIRE(buf.push_buffer(write_data));
+
+            THEN("peek_read() should return it as a single span") {
+                const auto peeked = buf.peek_read();
+                REQUIRE(std::ranges::equal(peeked, write_data));
+            }
+
+            THEN("Iterating over the buffer should return it in order") {
+                REQUIRE(std::ranges::equal(buf, write_data));
+                REQUIRE(std::ranges::size(buf) == write_data.size());
+            }
+
+            THEN("Reading it via pop_buffer() should return the same data") {
+                auto read_data = std::vector<uint32_t>(write_data.size());
+                REQUIRE(buf.pop_buffer(read_data));
+                REQUIRE(read_data == write_data);
+                REQUIRE(buf.empty());
+            }
+
+            THEN("Reading it via pop() should return the same data") {
+                for (auto value : write_data) {
+                    REQUIRE(buf.pop() == value);
+                }
+
+                auto result = buf.pop();
+                REQUIRE(!result.has_value());
+                REQUIRE(result.error() == Error::Empty());
+            }
+        }
+
+        WHEN("The buffer is filled in place") {
+            auto space = buf.prepare_write(capacity);
+            REQUIRE(space.has_value());
+            REQUIRE(space->size() == capacity);
+
+            std::iota(space->begin(), space->end(), uint32_t{0});
+            REQUIRE(buf.commit_write(capacity));
+
+            THEN("It should be full") {
+                REQUIRE(buf.full());
+                REQUIRE(!buf.push(0));
+                REQUIRE(!buf.prepare_write(1));
+            }
+
+            THEN("The data should be read back in order") {
+                auto expected = uint32_t{0};
+                auto in_order = true;
+
+                for (auto value : buf.peek_read()) {
+                    in_order = in_order && value == expected++;
+                }
+
+                REQUIRE(in_order);
+            }
+        }
+    }
+}
@@ -0,0 +1,259 @@
+/// Tests for MpmcRingBuffer.
+
+#include <atomic>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+#include "mpmc.hpp"
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity>
+using MpmcRingBuffer = core::ringbuf::MpmcRingBuffer<T, Capacity>;
+
+using Error = core::ringbuf::Error;
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("MpmcRingBuffer empty and full properties") {
+    GIVEN("An empty MpmcRingBuffer") {
+        constexpr auto CAPACITY = 32;
+        auto buf = MpmcRingBuffer<uint32_t, CAPACITY>{};
+        REQUIRE(buf.capacity() == CAPACITY);
+
+        auto offset = GENERATE(0, CAPACITY / 2, CAPACITY - 1, 3 * CAPACITY);
+        for (auto i : std::views::iota(0, offset)) {
+            REQUIRE(buf.try_push((uint32_t)i));
+            REQUIRE(buf.try_pop());
+        }
+
+        THEN("The buffer should be empty") {
+            REQUIRE(buf.empty());
+            REQUIRE(!buf.full());
+            REQUIRE(buf.size() == 0);
+            REQUIRE(buf.free() == CAPACITY);
+        }
+
+        THEN("Calling try_pop() should return an error") {
+            auto result = buf.try_pop();
+            REQUIRE(!result.has_value());
+            REQUIRE(result.error() == Error::Empty());
+        }
+
+        WHEN("The buffer is filled") {
+            for (auto i : std::views::iota(0, CAPACITY)) {
+                REQUIRE(buf.try_push((uint32_t)i));
+            }
+
+            THEN("The buffer should be full") {
+                REQUIRE(buf.full());
+                REQUIRE(buf.size() == CAPACITY);
+                REQUIRE(buf.free() == 0);
+            }
+
+            THEN("Calling try_push() should return an error") {
+                auto result = buf.try_push(0);
+                REQUIRE(!result.has_value());
+                REQUIRE(result.error() == Error::Full());
+            }
+
+            THEN("The data should be read in the order it was written") {
+                for (auto i : std::views::iota(0, CAPACITY)) {
+                    REQUIRE(buf.try_pop() == (uint32_t)i);
+                }
+
+                REQUIRE(buf.empty());
+            }
+        }
+    }
+}
+
+SCENARIO("MpmcRingBuffer batch transfers") {
+    GIVEN("An MpmcRingBuffer with its positions at an offset") {
+        constexpr auto CAPACITY = 64;
+        auto buf = MpmcRingBuffer<uint32_t, CAPACITY>{};
+
+        auto offset = GENERATE(0, 1, CAPACITY - 1, CAPACITY + 7);
+        for (auto i : std::views::iota(0, offset)) {
+            REQUIRE(buf.try_push((uint32_t)i));
+            REQUIRE(buf.try_pop());
+        }
+
+        auto count = GENERATE(size_t{1}, size_t{CAPACITY / 2}, size_t{CAPACITY});
+        auto write_data = std::vector<uint32_t>(count);
+        for (auto i : std::views::iota(size_t{0}, count)) {
+            write_data[i] = (uint32_t)(i * 3);
+        }
+
+        WHEN("Data is pushed via try_push_buffer()") {
+            REQUIRE(buf.try_push_buffer(write_data));
+            REQUIRE(buf.size() == count);
+
+            THEN("Reading it back via try_pop_buffer() should return the same data") {
+                auto read_data = std::vector<uint32_t>(count);
+                REQUIRE(buf.try_pop_buffer(read_data));
+                REQUIRE(read_data == write_data);
+                REQUIRE(buf.empty());
+            }
+
+            THEN("Reading it back via try_pop() should return the same data in order") {
+                for (auto value : write_data) {
+                    REQUIRE(buf.try_pop() == value);
+                }
+            }
+
+            THEN("Reading more data than is present should return an error") {
+                auto read_data = std::vector<uint32_t>(count + 1);
+                auto result = buf.try_pop_buffer(read_data);
+                REQUIRE(!result.has_value());
+                REQUIRE(result.error() == Error::Empty());
+                REQUIRE(buf.size() == count);
+            }
+
+            THEN("Writing more data than there is space for should return an error") {
+                auto extra = std::vector<uint32_t>(buf.free() + 1);
+                auto result = buf.try_push_buffer(extra);
+                REQUIRE(!result.has_value());
+                REQUIRE(result.error() == Error::Full());
+                REQUIRE(buf.size() == count);
+            }
+        }
+    }
+}
+
+SCENARIO("MpmcRingBuffer transfers data between many threads") {
+    GIVEN("Several producers and consumers sharing an MpmcRingBuffer") {
+        constexpr auto CAPACITY = 64;
+        constexpr auto THREADS = 4;
+        constexpr auto PER_PRODUCER = uint32_t{20'000};
+        constexpr auto BATCH = size_t{8};
+
+        auto buf = MpmcRingBuffer<uint32_t, CAPACITY>{};
+        auto bulk = GENERATE(false, true);
+
+        WHEN("Each producer writes its own range of values") {
+            auto received = std::vector<std::vector<uint32_t>>(THREADS);
+            auto remaining = std::atomic<uint32_t>{THREADS * PER_PRODUCER};
+
+            {
+                auto threads = std::vector<std::jthread>{};
+
+                for (auto p : std::views::iota(uint32_t{0}, uint32_t{THREADS})) {
+                    threads.emplace_back([&, p] {
+                        auto chunk = std::array<uint32_t, BATCH>{};
+
+                        for (auto next = p * PER_PRODUCER; next < (p + 1) * PER_PRODUCER;) {
+                            if (bulk) {
+                                for (auto& value : chunk) value = next++;
+                                while (!buf.try_push_buffer(chunk)) continue;
+                            } else {
+                                while (!buf.try_push(next)) continue;
+                                next++;
+                            }
+                        }
+                    });
+                }
+
+                for (auto c : std::views::iota(0, THREADS)) {
+                    threads.emplace_back([&, c] {
+                        auto chunk = std::array<uint32_t, BATCH>{};
+
+                        while (remaining.load(std::memory_order_relaxed) > 0) {
+                            if (bulk && buf.try_pop_buffer(chunk)) {
+                                remaining.fetch_sub(BATCH, std::memory_order_relaxed);
+                                received[c].insert(received[c].end(), chunk.begin(), chunk.end());
+                            } else if (auto value = buf.try_pop(); value) {
+                                remaining.fetch_sub(1, std::memory_order_relaxed);
+                                received[c].push_back(*value);
+                            }
+                        }
+                    });
+                }
+            }
+
+            THEN("Every value should be received exactly once") {
+                auto seen = std::vector<uint8_t>(THREADS * PER_PRODUCER);
+
+                for (const auto& values : received) {
+                    for (auto value : values) seen[value]++;
+                }
+
+                REQUIRE(std::ranges::all_of(seen, [](const uint8_t count) { return count == 1; }));
+                REQUIRE(buf.empty());
+            }
+
+            THEN("Each consumer should see each producer's values in order") {
+                auto in_order = true;
+
+                for (const auto& values : received) {
+                    auto last = std::vector<int64_t>(THREADS, -1);
+
+                    for (auto value : values) {
+                        const auto producer = value / PER_PRODUCER;
+                        in_order = in_order && (int64_t)value > last[producer];
+                        last[producer] = value;
+                    }
+                }
+
+                REQUIRE(in_order);
+            }
+        }
+    }
+}
+
+SCENARIO("MpmcRingBuffer batch pops never claim elements which haven't been pushed") {
+    GIVEN("Several consumers polling a nearly empty MpmcRingBuffer with try_pop_buffer()") {
+        constexpr auto CONSUMERS = 4;
+        constexpr auto COUNT = uint32_t{50'000};
+        constexpr auto BATCH = size_t{2};
+
+        auto buf = MpmcRingBuffer<uint32_t, 16>{};
+
+        WHEN("A single producer pushes values one at a time") {
+            auto received = std::vector<std::vector<uint32_t>>(CONSUMERS);
+            auto remaining = std::atomic<uint32_t>{COUNT};
+
+            {
+                auto threads = std::vector<std::jthread>{};
+
+                threads.emplace_back([&] {
+                    for (auto value = uint32_t{0}; value < COUNT; value++) {
+                        while (!buf.try_push(value)) std::this_thread::yield();
+                    }
+                });
+
+                // A consumer which claimed past the last value pushed would block forever.
+                for (auto c : std::views::iota(0, CONSUMERS)) {
+                    threads.emplace_back([&, c] {
+                        auto chunk = std::array<uint32_t, BATCH>{};
+
+                        while (remaining.load(std::memory_order_relaxed) > 0) {
+                            if (buf.try_pop_buffer(chunk)) {
+                                remaining.fetch_sub(BATCH, std::memory_order_relaxed);
+                                received[c].insert(received[c].end(), chunk.begin(), chunk.end());
+                            } else {
+                                std::this_thread::yield();
+                            }
+                        }
+                    });
+                }
+            }
+
+            THEN("Every value should be received exactly once") {
+                auto seen = std::vector<uint8_t>(COUNT);
+
+                for (const auto& values : received) {
+                    for (auto value : values) seen[value]++;
+                }
+
+                REQUIRE(std::ranges::all_of(seen, [](const uint8_t count) { return count == 1; }));
+                REQUIRE(buf.empty());
+            }
+        }
+    }
+}
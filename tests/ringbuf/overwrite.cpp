@@ -0,0 +1,136 @@
+/// Tests for OverwriteRingBuffer.
+
+#include <ranges>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+#include "overwrite.hpp"
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity>
+using OverwriteRingBuffer = core::ringbuf::OverwriteRingBuffer<T, Capacity>;
+
+template<typename T>
+using DynamicOverwriteRingBuffer = core::ringbuf::DynamicOverwriteRingBuffer<T>;
+
+using Error = core::ringbuf::Error;
+
+////////////////////////////////////////////////////////////////
+
+// The writes of RingBuffer, which fail rather than overwrite, can't be reached.
+static_assert(!std::is_convertible_v<OverwriteRingBuffer<uint32_t, 8>&,
+                                     core::ringbuf::RingBuffer<uint32_t, 8>&>);
+template<typename B>
+concept RejectingWrites = requires(B buf) { buf.push_unchecked(1); } ||
+                          requires(B buf) { buf.prepare_write(1); };
+
+static_assert(RejectingWrites<core::ringbuf::RingBuffer<uint32_t, 8>>);
+static_assert(!RejectingWrites<OverwriteRingBuffer<uint32_t, 8>>);
+static_assert(std::ranges::range<OverwriteRingBuffer<uint32_t, 8>>);
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("OverwriteRingBuffer drops the oldest elements when full") {
+    GIVEN("A full OverwriteRingBuffer") {
+        constexpr auto CAPACITY = 10;
+        auto buf = OverwriteRingBuffer<uint32_t, CAPACITY>{};
+
+        auto offset = GENERATE(0, CAPACITY / 2, CAPACITY - 1);
+        for (auto i : std::views::iota(0, offset)) {
+            buf.push((uint32_t)i);
+            REQUIRE(buf.pop());
+        }
+
+        for (auto i : std::views::iota(uint32_t{0}, uint32_t{CAPACITY})) {
+            buf.push(i);
+        }
+
+        REQUIRE(buf.full());
+        REQUIRE(buf.dropped() == 0);
+
+        WHEN("More elements are pushed") {
+            buf.push(CAPACITY);
+            buf.emplace(CAPACITY + 1);
+
+            THEN("The oldest elements should have been overwritten") {
+                REQUIRE(buf.full());
+                REQUIRE(buf.dropped() == 2);
+
+                for (auto i : std::views::iota(uint32_t{2}, uint32_t{CAPACITY + 2})) {
+                    REQUIRE(buf.pop() == i);
+                }
+            }
+        }
+
+        WHEN("A buffer which doesn't fill the ring is pushed") {
+            const auto data = std::vector<uint32_t>{100, 101, 102, 103};
+            buf.push_buffer(data);
+
+            THEN("Only as many elements as needed should be dropped") {
+                REQUIRE(buf.dropped() == data.size());
+                REQUIRE(buf.size() == CAPACITY);
+
+                for (auto i : std::views::iota(data.size(), size_t{CAPACITY})) {
+                    REQUIRE(buf.pop() == (uint32_t)i);
+                }
+
+                for (auto value : data) {
+                    REQUIRE(buf.pop() == value);
+                }
+            }
+        }
+
+        WHEN("A buffer larger than the capacity is pushed") {
+            auto data = std::vector<uint32_t>(CAPACITY + 5);
+            for (auto i : std::views::iota(size_t{0}, data.size())) {
+                data[i] = (uint32_t)(1000 + i);
+            }
+
+            buf.push_buffer(data);
+
+            THEN("The previous contents and the start of the buffer should be dropped") {
+                REQUIRE(buf.dropped() == CAPACITY + 5);
+                REQUIRE(buf.size() == CAPACITY);
+
+                for (auto value : std::span(data).last(CAPACITY)) {
+                    REQUIRE(buf.pop() == value);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("OverwriteRingBuffer with a runtime capacity") {
+    GIVEN("A capacity of zero") {
+        THEN("Creating a buffer should return an error") {
+            auto buf = DynamicOverwriteRingBuffer<uint8_t>::create(0);
+            REQUIRE(!buf.has_value());
+            REQUIRE(buf.error() == Error::Alloc());
+        }
+    }
+
+    GIVEN("A buffer of strings") {
+        auto buf = DynamicOverwriteRingBuffer<std::string>::create(3);
+        REQUIRE(buf.has_value());
+
+        WHEN("More strings are pushed than it can hold") {
+            for (auto i : std::views::iota(0, 5)) {
+                buf->push(std::to_string(i));
+            }
+
+            THEN("Only the newest strings should remain") {
+                REQUIRE(buf->dropped() == 2);
+                REQUIRE(buf->pop() == "2");
+                REQUIRE(buf->pop() == "3");
+                REQUIRE(buf->pop() == "4");
+                REQUIRE(buf->empty());
+            }
+        }
+    }
+}
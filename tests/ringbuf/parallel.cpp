@@ -0,0 +1,110 @@
+/// Tests for the execution policy algorithms.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <execution>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+#include "parallel.hpp"
+#include "ringbuf.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T>
+using DynamicRingBuffer = core::ringbuf::DynamicRingBuffer<T>;
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("Algorithms run over the segments of a RingBuffer under an execution policy") {
+    GIVEN("A large RingBuffer whose contents may wrap the end of its storage") {
+        constexpr auto CAPACITY = size_t{100'000};
+        auto buf = std::move(*DynamicRingBuffer<uint32_t>::create(CAPACITY));
+
+        const auto offset = GENERATE(size_t{0}, CAPACITY / 3, CAPACITY - 1);
+        for (auto i = size_t{0}; i < offset; i++) {
+            REQUIRE(buf.push(0));
+            REQUIRE(buf.pop());
+        }
+
+        const auto count = GENERATE(size_t{0}, size_t{1}, size_t{5'000}, CAPACITY);
+        auto expected = std::vector<uint32_t>{};
+
+        for (auto i : std::views::iota(uint32_t{0}, static_cast<uint32_t>(count))) {
+            REQUIRE(buf.push(i * 3));
+            expected.push_back(i * 3);
+        }
+
+        const auto check = [&](const auto& policy) {
+            auto visited = std::vector<std::atomic<uint32_t>>(count);
+            core::ringbuf::for_each(policy, buf, [&](const uint32_t value) {
+                visited[value / 3].fetch_add(1, std::memory_order_relaxed);
+            });
+
+            REQUIRE(std::ranges::all_of(visited, [](const auto& n) { return n.load() == 1; }));
+
+            auto output = std::vector<uint32_t>(count);
+            const auto end = core::ringbuf::transform(
+                policy, buf, output.begin(), [](const uint32_t value) { return value + 1; });
+
+            REQUIRE(end == output.end());
+            for (auto i = size_t{0}; i < count; i++) {
+                REQUIRE(output[i] == expected[i] + 1);
+            }
+
+            const auto sum = core::ringbuf::reduce(policy, buf, uint64_t{7});
+            REQUIRE(sum == std::accumulate(expected.begin(), expected.end(), uint64_t{7}));
+
+            // The elements themselves can be modified in place.
+            core::ringbuf::for_each(policy, buf, [](uint32_t& value) { value++; });
+            REQUIRE(std::ranges::equal(buf, output));
+        };
+
+        WHEN("The policy is seq") {
+            check(std::execution::seq);
+        }
+
+        WHEN("The policy is unseq") {
+            check(std::execution::unseq);
+        }
+
+        WHEN("The policy is par") {
+            check(std::execution::par);
+        }
+
+        WHEN("The policy is par_unseq") {
+            check(std::execution::par_unseq);
+        }
+    }
+}
+
+SCENARIO("Chunks for the parallel algorithms cover the segments exactly") {
+    GIVEN("Segments which wrap the end of the storage") {
+        auto storage = std::vector<int>(50'000);
+        std::iota(storage.begin(), storage.end(), 0);
+
+        const auto split = GENERATE(size_t{0}, size_t{1}, size_t{12'345}, size_t{50'000});
+        const auto segments = core::ringbuf::Segments<int>{
+            std::span{storage}.subspan(split),
+            std::span{storage}.first(split),
+        };
+
+        THEN("Every chunk should be non-empty, within one segment, and at its offset") {
+            const auto chunks = core::ringbuf::parallel_impl::split(segments);
+            auto offset = size_t{0};
+
+            for (const auto& chunk : chunks) {
+                REQUIRE(!chunk.elements.empty());
+                REQUIRE(chunk.offset == offset);
+                offset += chunk.elements.size();
+            }
+
+            REQUIRE(offset == storage.size());
+        }
+    }
+}
@@ -0,0 +1,158 @@
+/// Tests for SharedRingBuffer.
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string>
+
+#include <unistd.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+#include "shared.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T>
+using SharedRingBuffer = core::ringbuf::SharedRingBuffer<T>;
+
+using Error = core::ringbuf::Error;
+
+////////////////////////////////////////////////////////////////
+
+/// Name of a shared memory object which is unique to this process.
+auto unique_name() -> std::string {
+    static auto next = 0;
+    return "/core-ringbuf-test-" + std::to_string(getpid()) + "-" + std::to_string(next++);
+}
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("A SharedRingBuffer is shared between two mappings") {
+    GIVEN("A SharedRingBuffer and a second handle attached to it") {
+        const auto name = unique_name();
+        const auto capacity = GENERATE(size_t{8}, size_t{5});
+
+        auto producer = std::move(*SharedRingBuffer<uint32_t>::create(name.c_str(), capacity));
+        auto consumer = std::move(*SharedRingBuffer<uint32_t>::attach(name.c_str()));
+
+        REQUIRE(SharedRingBuffer<uint32_t>::unlink(name.c_str()));
+
+        THEN("Both should see the same capacity, rounded up to a power of two") {
+            REQUIRE(producer.capacity() == 8);
+            REQUIRE(consumer.capacity() == 8);
+            REQUIRE(consumer.empty());
+        }
+
+        WHEN("Elements are pushed through one handle") {
+            for (auto i = uint32_t{0}; i < 8; i++) {
+                REQUIRE(producer.push(i));
+            }
+
+            THEN("The buffer should be full through both") {
+                REQUIRE(producer.full());
+                REQUIRE(consumer.full());
+                REQUIRE(producer.push(99).error() == Error::Full());
+            }
+
+            THEN("They should be popped in order through the other") {
+                for (auto i = uint32_t{0}; i < 8; i++) {
+                    REQUIRE(consumer.pop() == i);
+                }
+
+                REQUIRE(consumer.pop().error() == Error::Empty());
+                REQUIRE(producer.empty());
+            }
+        }
+
+        WHEN("Buffers are pushed and popped across the end of the storage") {
+            auto input = std::array<uint32_t, 6>{};
+            auto output = std::array<uint32_t, 6>{};
+            std::iota(input.begin(), input.end(), uint32_t{1});
+
+            REQUIRE(producer.push_buffer(input));
+            REQUIRE(consumer.pop_buffer(output));
+            REQUIRE(producer.push_buffer(input));
+
+            THEN("Every element should make it across in order") {
+                REQUIRE(consumer.pop_buffer(output));
+                REQUIRE(output == input);
+                REQUIRE(consumer.empty());
+            }
+
+            THEN("A buffer larger than the free space should be rejected whole") {
+                REQUIRE(producer.push_buffer(input).error() == Error::Full());
+                REQUIRE(consumer.size() == 6);
+            }
+        }
+    }
+}
+
+SCENARIO("Attaching to a SharedRingBuffer checks its layout") {
+    GIVEN("A SharedRingBuffer of uint32_t") {
+        const auto name = unique_name();
+        auto buf = std::move(*SharedRingBuffer<uint32_t>::create(name.c_str(), 16));
+
+        THEN("Attaching as a different element type should fail with Layout") {
+            REQUIRE(SharedRingBuffer<uint64_t>::attach(name.c_str()).error() == Error::Layout());
+            REQUIRE(SharedRingBuffer<uint8_t>::attach(name.c_str()).error() == Error::Layout());
+        }
+
+        WHEN("Its header says the indices are on a different cache line size") {
+            const auto region = *core::ringbuf::shared_impl::attach(name.c_str());
+            auto* const header = reinterpret_cast<core::ringbuf::shared_impl::Header*>(region.base);
+
+            header->header_size *= 2;
+            header->data_offset *= 2;
+            core::ringbuf::shared_impl::unmap(region);
+
+            THEN("Attaching to it should fail with Layout") {
+                REQUIRE(SharedRingBuffer<uint32_t>::attach(name.c_str()).error() == Error::Layout());
+            }
+        }
+
+        WHEN("Its header claims a capacity whose size in bytes wraps around") {
+            const auto region = *core::ringbuf::shared_impl::attach(name.c_str());
+            auto* const header = reinterpret_cast<core::ringbuf::shared_impl::Header*>(region.base);
+
+            header->capacity = uint64_t{1} << 62;
+            core::ringbuf::shared_impl::unmap(region);
+
+            THEN("Attaching to it should fail with Layout") {
+                const auto attached = SharedRingBuffer<uint32_t>::attach(name.c_str());
+                REQUIRE(attached.error() == Error::Layout());
+            }
+        }
+
+        THEN("Creating one too large for the address space should fail with Alloc") {
+            const auto huge = unique_name();
+            const auto max = std::numeric_limits<size_t>::max();
+
+            REQUIRE(SharedRingBuffer<uint32_t>::create(huge.c_str(), max).error()
+                    == Error::Alloc());
+            REQUIRE(SharedRingBuffer<uint32_t>::create(huge.c_str(), max / 4).error()
+                    == Error::Alloc());
+        }
+
+        THEN("Creating another with the same name should fail") {
+            REQUIRE(SharedRingBuffer<uint32_t>::create(name.c_str(), 16).error() == Error::Alloc());
+        }
+
+        WHEN("It's unlinked") {
+            REQUIRE(SharedRingBuffer<uint32_t>::unlink(name.c_str()));
+
+            THEN("It should no longer be possible to attach to it") {
+                REQUIRE(SharedRingBuffer<uint32_t>::attach(name.c_str()).error() == Error::Alloc());
+            }
+
+            THEN("The existing handle should still work") {
+                REQUIRE(buf.push(1));
+                REQUIRE(buf.pop() == 1);
+            }
+        }
+
+        static_cast<void>(SharedRingBuffer<uint32_t>::unlink(name.c_str()));
+    }
+}
@@ -0,0 +1,174 @@
+/// Tests for SpscRingBuffer.
+
+#include <ranges>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+#include "ringbuf.hpp"
+#include "spsc.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity>
+using SpscRingBuffer = core::ringbuf::SpscRingBuffer<T, Capacity>;
+
+using Error = core::ringbuf::Error;
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("SpscRingBuffer empty and full properties") {
+    GIVEN("An empty SpscRingBuffer") {
+        constexpr auto CAPACITY = 48;
+        auto buf = SpscRingBuffer<uint8_t, CAPACITY>{};
+        REQUIRE(buf.capacity() == CAPACITY);
+
+        // Move the internal indices so they start at different positions, including past the point
+        // where they wrap at twice the capacity.
+        auto offset =
+            GENERATE(0, CAPACITY / 2, auto{CAPACITY}, CAPACITY + (CAPACITY / 2), 2 * CAPACITY);
+
+        for (auto i : std::views::iota(0, offset)) {
+            REQUIRE(buf.push((uint8_t)i));
+            REQUIRE(buf.pop());
+        }
+
+        THEN("The buffer should be empty") {
+            REQUIRE(buf.empty());
+            REQUIRE(!buf.full());
+            REQUIRE(buf.size() == 0);
+            REQUIRE(buf.free() == CAPACITY);
+        }
+
+        THEN("Calling pop() should return an error") {
+            auto result = buf.pop();
+            REQUIRE(!result.has_value());
+            REQUIRE(result.error() == Error::Empty());
+        }
+
+        WHEN("The buffer is filled") {
+            for (auto i : std::views::iota(0, CAPACITY)) {
+                REQUIRE(buf.push((uint8_t)i));
+            }
+
+            THEN("The buffer should be full") {
+                REQUIRE(buf.full());
+                REQUIRE(!buf.empty());
+                REQUIRE(buf.size() == CAPACITY);
+                REQUIRE(buf.free() == 0);
+            }
+
+            THEN("Calling push() should return an error") {
+                auto result = buf.push(0);
+                REQUIRE(!result.has_value());
+                REQUIRE(result.error() == Error::Full());
+            }
+
+            THEN("The data should be read in the order it was written") {
+                for (auto i : std::views::iota(0, CAPACITY)) {
+                    REQUIRE(buf.pop() == (uint8_t)i);
+                }
+
+                REQUIRE(buf.empty());
+            }
+        }
+    }
+}
+
+SCENARIO("SpscRingBuffer bulk transfers") {
+    GIVEN("An SpscRingBuffer with its indices at an offset") {
+        constexpr auto CAPACITY = 64;
+        auto buf = SpscRingBuffer<uint32_t, CAPACITY>{};
+
+        auto offset = GENERATE(0, 1, CAPACITY / 2, CAPACITY - 1, CAPACITY + 7);
+        for (auto i : std::views::iota(0, offset)) {
+            REQUIRE(buf.push((uint32_t)i));
+            REQUIRE(buf.pop());
+        }
+
+        auto count = GENERATE(size_t{1}, size_t{CAPACITY / 2}, size_t{CAPACITY});
+        auto write_data = std::vector<uint32_t>(count);
+        for (auto i : std::views::iota(size_t{0}, count)) {
+            write_data[i] = (uint32_t)(i * 3);
+        }
+
+        WHEN("Data is pushed via push_buffer()") {
+            REQUIRE(buf.push_buffer(write_data));
+            REQUIRE(buf.size() == count);
+
+            THEN("Reading it back via pop_buffer() should return the same data") {
+                auto read_data = std::vector<uint32_t>(count);
+                REQUIRE(buf.pop_buffer(read_data));
+                REQUIRE(read_data == write_data);
+                REQUIRE(buf.empty());
+            }
+
+            THEN("Reading more data than is present should return an error") {
+                auto read_data = std::vector<uint32_t>(count + 1);
+                auto result = buf.pop_buffer(read_data);
+                REQUIRE(!result.has_value());
+                REQUIRE(result.error() == Error::Empty());
+                REQUIRE(buf.size() == count);
+            }
+
+            THEN("Writing more data than there is space for should return an error") {
+                auto extra = std::vector<uint32_t>(buf.free() + 1);
+                auto result = buf.push_buffer(extra);
+                REQUIRE(!result.has_value());
+                REQUIRE(result.error() == Error::Full());
+                REQUIRE(buf.size() == count);
+            }
+        }
+    }
+}
+
+SCENARIO("SpscRingBuffer transfers data between threads") {
+    GIVEN("A producer and consumer thread sharing an SpscRingBuffer") {
+        constexpr auto CAPACITY = 128;
+        constexpr auto COUNT = uint32_t{200'000};
+        auto buf = SpscRingBuffer<uint32_t, CAPACITY>{};
+
+        auto bulk = GENERATE(false, true);
+
+        WHEN("The producer writes an increasing sequence") {
+            auto producer = std::jthread([&] {
+                auto chunk = std::array<uint32_t, 16>{};
+                auto next = uint32_t{0};
+
+                while (next < COUNT) {
+                    if (bulk && (COUNT - next) >= chunk.size()) {
+                        for (auto& value : chunk) value = next++;
+                        while (!buf.push_buffer(chunk)) continue;
+                    } else {
+                        while (!buf.push(next)) continue;
+                        next++;
+                    }
+                }
+            });
+
+            auto received = std::vector<uint32_t>{};
+            received.reserve(COUNT);
+
+            while (received.size() < COUNT) {
+                if (auto value = buf.pop(); value) {
+                    received.push_back(*value);
+                }
+            }
+
+            producer.join();
+
+            THEN("The consumer should read every value in order") {
+                auto in_order = true;
+
+                for (auto i : std::views::iota(uint32_t{0}, COUNT)) {
+                    in_order = in_order && received[i] == i;
+                }
+
+                REQUIRE(in_order);
+                REQUIRE(buf.empty());
+            }
+        }
+    }
+}
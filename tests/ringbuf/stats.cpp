@@ -0,0 +1,214 @@
+/// Tests for the Stats policy.
+
+#include <array>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "mpmc.hpp"
+#include "ringbuf.hpp"
+#include "spsc.hpp"
+#include "stats.hpp"
+
+////////////////////////////////////////////////////////////////
+
+constexpr auto CAPACITY = size_t{8};
+
+using Stats = core::ringbuf::Stats;
+
+using RingBuffer = core::ringbuf::RingBuffer<uint32_t, CAPACITY, Stats>;
+using SpscRingBuffer = core::ringbuf::SpscRingBuffer<uint32_t, CAPACITY, Stats>;
+using MpmcRingBuffer = core::ringbuf::MpmcRingBuffer<uint32_t, CAPACITY, Stats>;
+
+static_assert(sizeof(core::ringbuf::RingBuffer<uint32_t, CAPACITY>) <
+              sizeof(core::ringbuf::RingBuffer<uint32_t, CAPACITY, Stats>));
+static_assert(sizeof(core::ringbuf::SpscRingBuffer<uint32_t, CAPACITY>) <
+              sizeof(core::ringbuf::SpscRingBuffer<uint32_t, CAPACITY, Stats>));
+
+////////////////////////////////////////////////////////////////
+
+/// MpmcRingBuffer's non-waiting functions have a try_ prefix.
+template<typename Buffer>
+auto push(Buffer& buf, const uint32_t value) {
+    if constexpr (requires { buf.try_push(value); }) {
+        return buf.try_push(value);
+    } else {
+        return buf.push(value);
+    }
+}
+
+template<typename Buffer>
+auto pop(Buffer& buf) {
+    if constexpr (requires { buf.try_pop(); }) {
+        return buf.try_pop();
+    } else {
+        return buf.pop();
+    }
+}
+
+template<typename Buffer>
+auto push_buffer(Buffer& buf, const std::span<const uint32_t> input) {
+    if constexpr (requires { buf.try_push_buffer(input); }) {
+        return buf.try_push_buffer(input);
+    } else {
+        return buf.push_buffer(input);
+    }
+}
+
+template<typename Buffer>
+auto pop_buffer(Buffer& buf, const std::span<uint32_t> output) {
+    if constexpr (requires { buf.try_pop_buffer(output); }) {
+        return buf.try_pop_buffer(output);
+    } else {
+        return buf.pop_buffer(output);
+    }
+}
+
+////////////////////////////////////////////////////////////////
+
+template<typename Buffer>
+auto check_counters() -> void {
+    auto buf = Buffer{};
+
+    WHEN("The buffer is filled past capacity then emptied past empty") {
+        for (auto i = uint32_t{0}; i < CAPACITY; i++) {
+            REQUIRE(push(buf, i));
+        }
+
+        REQUIRE(!push(buf, 99));
+
+        for (auto i = uint32_t{0}; i < CAPACITY; i++) {
+            REQUIRE(pop(buf) == i);
+        }
+
+        REQUIRE(!pop(buf));
+
+        THEN("Each side should have counted its elements and failures") {
+            const auto stats = buf.stats();
+
+            REQUIRE(stats.producer.elements == CAPACITY);
+            REQUIRE(stats.producer.failures == 1);
+            REQUIRE(stats.consumer.elements == CAPACITY);
+            REQUIRE(stats.consumer.failures == 1);
+            REQUIRE(stats.high_water == CAPACITY);
+        }
+    }
+
+    WHEN("Elements are transferred in bulk") {
+        const auto input = std::array<uint32_t, 5>{1, 2, 3, 4, 5};
+        auto output = std::array<uint32_t, 5>{};
+
+        REQUIRE(push_buffer(buf, std::span(input).first(1)));
+        REQUIRE(push_buffer(buf, std::span(input).first(2)));
+        REQUIRE(push_buffer(buf, input));
+        REQUIRE(!push_buffer(buf, input));
+
+        REQUIRE(pop_buffer(buf, output));
+        REQUIRE(!pop_buffer(buf, output));
+
+        THEN("The sizes should be counted in power of two buckets") {
+            const auto stats = buf.stats();
+
+            REQUIRE(stats.producer.elements == 8);
+            REQUIRE(stats.producer.failures == 1);
+            REQUIRE(stats.producer.bulk[1] == 1);
+            REQUIRE(stats.producer.bulk[2] == 1);
+            REQUIRE(stats.producer.bulk[3] == 1);
+
+            REQUIRE(stats.consumer.elements == 5);
+            REQUIRE(stats.consumer.failures == 1);
+            REQUIRE(stats.consumer.bulk[3] == 1);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("Buffers with the Stats policy count their transfers and failures") {
+    GIVEN("A RingBuffer") {
+        check_counters<RingBuffer>();
+
+        WHEN("It's copied") {
+            auto buf = RingBuffer{};
+            REQUIRE(buf.push(1));
+
+            const auto copy = buf;
+
+            THEN("The copy should have the same counters") {
+                REQUIRE(copy.stats().producer.elements == 1);
+                REQUIRE(copy.stats().high_water == 1);
+            }
+        }
+    }
+
+    GIVEN("An SpscRingBuffer") {
+        check_counters<SpscRingBuffer>();
+    }
+
+    GIVEN("An MpmcRingBuffer") {
+        check_counters<MpmcRingBuffer>();
+    }
+}
+
+SCENARIO("Stats counted by concurrent threads add up") {
+    constexpr auto THREADS = size_t{4};
+    constexpr auto COUNT = uint32_t{10'000};
+
+    GIVEN("An SpscRingBuffer with a producer and a consumer thread") {
+        auto buf = SpscRingBuffer{};
+
+        auto producer = std::thread([&] {
+            for (auto i = uint32_t{0}; i < COUNT; i++) {
+                static_cast<void>(buf.push_wait(i));
+            }
+        });
+
+        for (auto i = uint32_t{0}; i < COUNT; i++) {
+            static_cast<void>(buf.pop_wait());
+        }
+
+        producer.join();
+
+        THEN("Every element should be counted once on each side") {
+            const auto stats = buf.stats();
+
+            REQUIRE(stats.producer.elements == COUNT);
+            REQUIRE(stats.consumer.elements == COUNT);
+            REQUIRE(stats.high_water <= CAPACITY);
+        }
+    }
+
+    GIVEN("An MpmcRingBuffer with several producer and consumer threads") {
+        auto buf = MpmcRingBuffer{};
+        auto threads = std::vector<std::thread>();
+
+        for (auto t = size_t{0}; t < THREADS; t++) {
+            threads.emplace_back([&] {
+                for (auto i = uint32_t{0}; i < COUNT; i++) {
+                    static_cast<void>(buf.push_wait(i));
+                }
+            });
+
+            threads.emplace_back([&] {
+                for (auto i = uint32_t{0}; i < COUNT; i++) {
+                    static_cast<void>(buf.pop_wait());
+                }
+            });
+        }
+
+        for (auto& thread : threads) thread.join();
+
+        THEN("Every element should be counted once on each side") {
+            const auto stats = buf.stats();
+
+            REQUIRE(stats.producer.elements == THREADS * COUNT);
+            REQUIRE(stats.consumer.elements == THREADS * COUNT);
+            REQUIRE(stats.producer.failures == 0);
+            REQUIRE(stats.consumer.failures == 0);
+            REQUIRE(stats.high_water <= CAPACITY);
+        }
+    }
+}
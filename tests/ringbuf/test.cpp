@@ -1,8 +1,10 @@
+#include <format>
 #include <ranges>
+#include <string>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators_all.hpp>
-#include <catch2/benchmark/catch_benchmark_all.hpp>
 
 #include "ringbuf.hpp"
 
@@ -11,6 +13,22 @@ using RingBuffer = core::ringbuf::RingBuffer<T, Capacity>;
 
 using Error = core::ringbuf::Error;
 
+/// Counts the number of live instances so element lifetimes can be checked.
+struct Tracked {
+    static inline auto live = 0;
+    static inline auto copies = 0;
+
+    explicit Tracked(const int value) : value{value} { live++; }
+    Tracked(const Tracked& other) : value{other.value} { live++, copies++; }
+    Tracked(Tracked&& other) noexcept : value{other.value} { live++; }
+    ~Tracked() { live--; }
+
+    auto operator=(const Tracked& other) -> Tracked& = default;
+    auto operator=(Tracked&& other) noexcept -> Tracked& = default;
+
+    int value;
+};
+
 SCENARIO("Empty RingBuffer properties") {
     GIVEN("An empty RingBuffer") {
         constexpr auto CAPACITY = 64;
@@ -168,17 +186,400 @@ SCENARIO("Data is read in the order it is written") {
     }
 }
 
-TEST_CASE("Benchmarks") {
-    constexpr auto CAPACITY = 64;
-    auto buf = RingBuffer<uint8_t, CAPACITY>{};
+SCENARIO("RingBuffer with a non power of two capacity") {
+    GIVEN("An empty RingBuffer") {
+        constexpr auto CAPACITY = 48;
+        auto buf = RingBuffer<uint8_t, CAPACITY>{};
+
+        auto offset = GENERATE(0, CAPACITY / 2, CAPACITY - 1, CAPACITY + (CAPACITY / 3));
+        for (auto i : std::views::iota(0, offset)) {
+            REQUIRE(buf.push((uint8_t)i));
+            REQUIRE(buf.pop());
+        }
+
+        WHEN("The buffer is filled") {
+            for (auto i : std::views::iota(0, CAPACITY)) {
+                REQUIRE(buf.push((uint8_t)i));
+            }
+
+            THEN("It should report being full") {
+                REQUIRE(buf.full());
+                REQUIRE(buf.size() == CAPACITY);
+                REQUIRE(buf.free() == 0);
+                REQUIRE(!buf.push(0));
+            }
+
+            THEN("Iterating should visit every element in order") {
+                auto expected = uint8_t{0};
+
+                for (auto value : buf) {
+                    REQUIRE(value == expected++);
+                }
+
+                REQUIRE(std::ranges::distance(buf) == CAPACITY);
+            }
+
+            THEN("The data should be read in the order it was written") {
+                for (auto i : std::views::iota(0, CAPACITY)) {
+                    REQUIRE(buf.pop() == (uint8_t)i);
+                }
+
+                REQUIRE(buf.empty());
+            }
+        }
+    }
+}
+
+SCENARIO("Data can be written and read in place") {
+    GIVEN("An empty RingBuffer with its pointers at an offset") {
+        constexpr auto CAPACITY = 64;
+        auto buf = RingBuffer<uint8_t, CAPACITY>{};
+
+        auto offset = GENERATE(0, CAPACITY / 4, CAPACITY - 8, auto{CAPACITY});
+        for (auto i : std::views::iota(0, offset)) {
+            REQUIRE(buf.push((uint8_t)i));
+            REQUIRE(buf.pop());
+        }
+
+        THEN("peek_read() should return no data") {
+            REQUIRE(buf.peek_read().empty());
+        }
+
+        THEN("Preparing more space than is free should return an error") {
+            auto result = buf.prepare_write(CAPACITY + 1);
+            REQUIRE(!result.has_value());
+            REQUIRE(result.error() == Error::Full());
+        }
+
+        THEN("Consuming from the empty buffer should return an error") {
+            auto result = buf.consume(1);
+            REQUIRE(!result.has_value());
+            REQUIRE(result.error() == Error::Empty());
+        }
+
+        WHEN("Data is written via prepare_write() and commit_write()") {
+            constexpr auto COUNT = size_t{16};
+
+            auto segments = buf.prepare_write(COUNT);
+            REQUIRE(segments.has_value());
+            REQUIRE(segments->size() == COUNT);
+
+            auto value = uint8_t{0};
+            for (auto& byte : segments->first) byte = value++;
+            for (auto& byte : segments->second) byte = value++;
+
+            THEN("The data should not be visible until it is committed") {
+                REQUIRE(buf.empty());
+            }
+
+            REQUIRE(buf.commit_write(COUNT));
+
+            THEN("The size should increase") {
+                REQUIRE(buf.size() == COUNT);
+            }
+
+            THEN("The data should be readable via pop()") {
+                for (auto i : std::views::iota(size_t{0}, COUNT)) {
+                    REQUIRE(buf.pop() == (uint8_t)i);
+                }
+            }
+
+            THEN("peek_read() should return the data in order") {
+                const auto peeked = buf.peek_read();
+                REQUIRE(peeked.size() == COUNT);
+
+                auto read_data = std::vector<uint8_t>(peeked.first.begin(), peeked.first.end());
+                read_data.insert(read_data.end(), peeked.second.begin(), peeked.second.end());
+
+                for (auto i : std::views::iota(size_t{0}, COUNT)) {
+                    REQUIRE(read_data[i] == (uint8_t)i);
+                }
+            }
+
+            AND_WHEN("Part of the data is consumed") {
+                REQUIRE(buf.consume(COUNT / 2));
+
+                THEN("The remaining data should be readable") {
+                    REQUIRE(buf.size() == COUNT / 2);
+                    REQUIRE(buf.pop() == (uint8_t)(COUNT / 2));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("RingBuffer elements are constructed and destroyed with their slots") {
+    GIVEN("An empty RingBuffer of a non-trivial type") {
+        constexpr auto CAPACITY = 6;
+        Tracked::live = 0;
+        Tracked::copies = 0;
+
+        {
+            auto buf = RingBuffer<Tracked, CAPACITY>{};
+
+            THEN("No elements should be constructed up front") {
+                REQUIRE(Tracked::live == 0);
+            }
+
+            WHEN("Elements are emplaced and moved in") {
+                auto offset = GENERATE(0, CAPACITY / 2, CAPACITY - 1);
+                for (auto i : std::views::iota(0, offset)) {
+                    REQUIRE(buf.emplace(i));
+                    REQUIRE(buf.pop());
+                }
+
+                REQUIRE(buf.emplace(0));
+                REQUIRE(buf.push(Tracked(1)));
+                REQUIRE(buf.push(Tracked(2)));
+
+                THEN("Only the stored elements should be alive and none should be copied") {
+                    REQUIRE(Tracked::live == 3);
+                    REQUIRE(Tracked::copies == 0);
+                }
+
+                THEN("pop() should move the element out and destroy the slot") {
+                    auto value = buf.pop();
+                    REQUIRE(value->value == 0);
+                    REQUIRE(Tracked::live == 3);
+
+                    value = buf.pop();
+                    REQUIRE(value->value == 1);
+                    REQUIRE(Tracked::live == 2);
+                    REQUIRE(Tracked::copies == 0);
+                }
+
+                THEN("consume() and clear() should destroy the elements") {
+                    REQUIRE(buf.consume(2));
+                    REQUIRE(Tracked::live == 1);
+
+                    buf.clear();
+                    REQUIRE(Tracked::live == 0);
+                }
+
+                THEN("Copying the buffer should copy each element once") {
+                    auto copy = buf;
+                    REQUIRE(Tracked::live == 6);
+                    REQUIRE(Tracked::copies == 3);
+                    REQUIRE(copy.pop()->value == 0);
+                    REQUIRE(copy.pop()->value == 1);
+                    REQUIRE(copy.pop()->value == 2);
+                }
+
+                THEN("Moving the buffer should leave the original empty") {
+                    auto moved = std::move(buf);
+                    REQUIRE(buf.empty());
+                    REQUIRE(moved.size() == 3);
+                    REQUIRE(Tracked::live == 3);
+                    REQUIRE(Tracked::copies == 0);
+                }
+
+                THEN("Filling the buffer should reject further elements") {
+                    for (auto i : std::views::iota(3, CAPACITY)) {
+                        REQUIRE(buf.emplace(i));
+                    }
+
+                    auto extra = Tracked(CAPACITY);
+                    REQUIRE(buf.push(std::move(extra)).error() == Error::Full());
+                    REQUIRE(Tracked::live == CAPACITY + 1);
+                }
+            }
+        }
+
+        THEN("Destroying the buffer should destroy every element") {
+            REQUIRE(Tracked::live == 0);
+        }
+    }
+}
+
+SCENARIO("RingBuffer holds strings and vectors") {
+    GIVEN("A RingBuffer of strings") {
+        constexpr auto CAPACITY = 8;
+        auto buf = RingBuffer<std::string, CAPACITY>{};
+
+        WHEN("Strings are pushed, emplaced and popped across the wrap") {
+            auto popped = std::vector<std::string>{};
+
+            for (auto i : std::views::iota(0, 3 * CAPACITY)) {
+                auto message = std::string(32, (char)('a' + (i % 26)));
+
+                if (i % 2 == 0) {
+                    REQUIRE(buf.push(std::move(message)));
+                } else {
+                    REQUIRE(buf.emplace(message.begin(), message.end()));
+                }
+
+                if (buf.size() > CAPACITY / 2) {
+                    popped.push_back(*buf.pop());
+                }
+            }
+
+            THEN("They should be read back in order") {
+                while (!buf.empty()) popped.push_back(buf.pop_unchecked());
+
+                REQUIRE(popped.size() == 3 * CAPACITY);
+                for (auto i : std::views::iota(0, 3 * CAPACITY)) {
+                    REQUIRE(popped[i] == std::string(32, (char)('a' + (i % 26))));
+                }
+            }
+        }
+    }
+
+    GIVEN("A RingBuffer of vectors") {
+        auto buf = RingBuffer<std::vector<int>, 4>{};
+        REQUIRE(buf.emplace(3, 7));
+        REQUIRE(buf.push(std::vector{1, 2}));
+
+        WHEN("They are popped in bulk via pop_buffer()") {
+            auto read_data = std::vector<std::vector<int>>(2);
+            REQUIRE(buf.pop_buffer(std::span(read_data).first(1)));
+            REQUIRE(buf.pop_buffer(std::span(read_data).last(1)));
+
+            THEN("The vectors should be moved out intact") {
+                REQUIRE(read_data[0] == std::vector{7, 7, 7});
+                REQUIRE(read_data[1] == std::vector{1, 2});
+                REQUIRE(buf.empty());
+            }
+        }
+    }
+}
+
+SCENARIO("Elements can be drained and filled in batches") {
+    GIVEN("Power of two and generic capacity RingBuffers with contents wrapping the end") {
+        auto buf = RingBuffer<uint32_t, 8>{};
+        auto generic = RingBuffer<uint32_t, 7>{};
+
+        for (auto i : std::views::iota(0, 6)) {
+            REQUIRE(buf.push((uint32_t)i));
+            REQUIRE(buf.pop());
+            REQUIRE(generic.push((uint32_t)i));
+            REQUIRE(generic.pop());
+        }
+
+        auto next = uint32_t{0};
+        const auto count = [&] { return next++; };
+
+        REQUIRE(buf.fill(5, count) == 5);
+        next = 0;
+        REQUIRE(generic.fill(5, count) == 5);
+
+        WHEN("Elements are drained") {
+            auto seen = std::vector<uint32_t>{};
+            auto seen_generic = std::vector<uint32_t>{};
+
+            const auto drained = buf.drain(3, [&](const uint32_t value) { seen.push_back(value); });
+            const auto drained_generic =
+                generic.drain(3, [&](const uint32_t value) { seen_generic.push_back(value); });
+
+            THEN("The oldest elements should be visited in order and removed") {
+                REQUIRE(drained == 3);
+                REQUIRE(seen == std::vector<uint32_t>{0, 1, 2});
+                REQUIRE(buf.size() == 2);
+                REQUIRE(buf.pop() == 3u);
+
+                REQUIRE(drained_generic == 3);
+                REQUIRE(seen_generic == seen);
+                REQUIRE(generic.size() == 2);
+                REQUIRE(generic.pop() == 3u);
+            }
+        }
+
+        WHEN("More elements are requested than are stored") {
+            auto sum = uint32_t{0};
+            const auto drained = buf.drain(100, [&](const uint32_t value) { sum += value; });
+
+            THEN("Only the stored elements should be drained") {
+                REQUIRE(drained == 5);
+                REQUIRE(sum == 0 + 1 + 2 + 3 + 4);
+                REQUIRE(buf.empty());
+            }
+        }
+
+        WHEN("drain_all() is called") {
+            const auto drained = generic.drain_all([](uint32_t) {});
+
+            THEN("The buffer should be emptied") {
+                REQUIRE(drained == 5);
+                REQUIRE(generic.empty());
+            }
+        }
+
+        WHEN("More elements are filled than there's space for") {
+            const auto filled = buf.fill(100, count);
+            const auto filled_generic = generic.fill(100, count);
+
+            THEN("The buffer should be filled up") {
+                REQUIRE(filled == 3);
+                REQUIRE(buf.full());
+                REQUIRE(filled_generic == 2);
+                REQUIRE(generic.full());
+            }
+        }
+    }
+
+    GIVEN("A RingBuffer of a non-trivial type") {
+        constexpr auto CAPACITY = 6;
+        Tracked::live = 0;
+        Tracked::copies = 0;
+
+        {
+            auto buf = RingBuffer<Tracked, CAPACITY>{};
+            auto next = 0;
+
+            REQUIRE(buf.fill(4, [&] { return Tracked(next++); }) == 4);
+            REQUIRE(Tracked::live == 4);
+
+            WHEN("The elements are moved out by drain()") {
+                auto moved = std::vector<Tracked>{};
+                moved.reserve(4);
+
+                buf.drain(2, [&](Tracked& element) { moved.push_back(std::move(element)); });
+
+                THEN("The drained slots should be destroyed without copying") {
+                    REQUIRE(moved[0].value == 0);
+                    REQUIRE(moved[1].value == 1);
+                    REQUIRE(Tracked::live == 4);
+                    REQUIRE(Tracked::copies == 0);
+                    REQUIRE(buf.pop()->value == 2);
+                }
+            }
+
+            WHEN("The callback throws part way through") {
+                auto visited = 0;
+
+                REQUIRE_THROWS(buf.drain_all([&](const Tracked&) {
+                    if (visited++ == 2) throw 0;
+                }));
+
+                THEN("The elements visited before the throw should be removed") {
+                    REQUIRE(buf.size() == 2);
+                    REQUIRE(buf.pop()->value == 2);
+                    REQUIRE(Tracked::live == 1);
+                }
+            }
+        }
+
+        THEN("Every element should be destroyed") {
+            REQUIRE(Tracked::live == 0);
+        }
+    }
+}
+
+SCENARIO("RingBuffer errors are formatted from their messages") {
+    GIVEN("An error") {
+        const auto error = Error{Error::Empty()};
+
+        THEN("Formatting it should produce its message") {
+            REQUIRE(error.message() == "Buffer empty");
+            REQUIRE(std::format("{}", error) == "Buffer empty");
+        }
 
-    BENCHMARK("push()") {
-        buf.push(0);
-        return buf.pop_unchecked();
-    };
+        THEN("Formatting it into a short buffer should truncate it") {
+            char out[6]{};
+            const auto result = error.format_to_n(out, sizeof(out));
 
-    BENCHMARK("push_unchecked()") {
-        buf.push_unchecked(0);
-        return buf.pop_unchecked();
-    };
+            REQUIRE(result.has_value());
+            REQUIRE(result->size == 12);
+            REQUIRE(std::string_view{out, result->out} == "Buffer");
+        }
+    }
 }
@@ -0,0 +1,169 @@
+/// Tests for LatencyHistogram and Traced.
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "latency.hpp"
+#include "traced.hpp"
+
+////////////////////////////////////////////////////////////////
+
+using namespace std::chrono_literals;
+
+constexpr auto CAPACITY = size_t{8};
+
+using Sharing = core::ringbuf::Sharing;
+
+using TracedRingBuffer = core::ringbuf::TracedRingBuffer<uint32_t, CAPACITY>;
+using TracedSpscRingBuffer = core::ringbuf::TracedSpscRingBuffer<uint32_t, CAPACITY>;
+using TracedMpmcRingBuffer = core::ringbuf::TracedMpmcRingBuffer<uint32_t, CAPACITY>;
+
+using Error = core::ringbuf::Error;
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("LatencyHistogram reads out percentiles") {
+    GIVEN("An empty histogram") {
+        auto histogram = core::ringbuf::LatencyHistogram<Sharing::None>{};
+
+        THEN("Every percentile should be zero") {
+            REQUIRE(histogram.count() == 0);
+            REQUIRE(histogram.percentile(0.5) == 0ns);
+        }
+    }
+
+    GIVEN("A histogram of the latencies 1ns to 1000ns") {
+        auto histogram = core::ringbuf::LatencyHistogram<Sharing::Multi>{};
+
+        for (auto i = 1; i <= 1000; i++) {
+            histogram.record(std::chrono::nanoseconds{i});
+        }
+
+        THEN("Each percentile should be within an eighth above the exact value") {
+            const auto percentiles = histogram.percentiles();
+
+            REQUIRE(histogram.count() == 1000);
+
+            REQUIRE(percentiles.p50 >= 500ns);
+            REQUIRE(percentiles.p50 <= 500ns + 500ns / 8);
+            REQUIRE(percentiles.p99 >= 990ns);
+            REQUIRE(percentiles.p99 <= 990ns + 990ns / 8);
+            REQUIRE(percentiles.p999 >= 999ns);
+            REQUIRE(percentiles.p999 <= 999ns + 999ns / 8);
+        }
+    }
+
+    GIVEN("A histogram of small latencies") {
+        auto histogram = core::ringbuf::LatencyHistogram<Sharing::Single>{};
+
+        histogram.record(3ns);
+        histogram.record(-1ns);
+
+        THEN("They should be counted exactly, with negative latencies as zero") {
+            REQUIRE(histogram.percentile(0.5) == 0ns);
+            REQUIRE(histogram.percentile(1.0) == 3ns);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////
+
+template<typename Buffer>
+auto check_round_trip() -> void {
+    auto buf = Buffer{};
+
+    WHEN("Elements wait in the buffer before being popped") {
+        REQUIRE(buf.push(1));
+        REQUIRE(buf.push(2));
+
+        std::this_thread::sleep_for(1ms);
+
+        REQUIRE(buf.pop() == 1);
+        REQUIRE(buf.pop() == 2);
+
+        THEN("Their sojourn times should be recorded") {
+            REQUIRE(buf.latency().count() == 2);
+            REQUIRE(buf.latency().percentile(0.5) >= 1ms);
+        }
+    }
+
+    WHEN("The buffer is empty") {
+        THEN("Popping should fail without recording anything") {
+            REQUIRE(buf.pop().error() == Error::Empty());
+            REQUIRE(buf.latency().count() == 0);
+        }
+    }
+}
+
+template<typename Buffer>
+auto check_batches() -> void {
+    auto buf = Buffer{};
+
+    WHEN("Elements are transferred in bulk") {
+        const auto input = std::array<uint32_t, 5>{1, 2, 3, 4, 5};
+        auto output = std::array<uint32_t, 5>{};
+
+        REQUIRE(buf.push_buffer(input));
+        REQUIRE(buf.push_buffer(input).error() == Error::Full());
+        REQUIRE(buf.buffer().size() == input.size());
+
+        REQUIRE(buf.pop_buffer(output));
+        REQUIRE(buf.pop_buffer(output).error() == Error::Empty());
+
+        THEN("Every element should be returned and timed") {
+            REQUIRE(output == input);
+            REQUIRE(buf.latency().count() == input.size());
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("Traced buffers record how long elements spend in them") {
+    GIVEN("A TracedRingBuffer") {
+        check_round_trip<TracedRingBuffer>();
+        check_batches<TracedRingBuffer>();
+    }
+
+    GIVEN("A TracedSpscRingBuffer") {
+        check_round_trip<TracedSpscRingBuffer>();
+        check_batches<TracedSpscRingBuffer>();
+    }
+
+    GIVEN("A TracedMpmcRingBuffer") {
+        check_round_trip<TracedMpmcRingBuffer>();
+    }
+
+    GIVEN("A TracedMpmcRingBuffer shared by several threads") {
+        constexpr auto THREADS = size_t{4};
+        constexpr auto COUNT = uint32_t{10'000};
+
+        auto buf = TracedMpmcRingBuffer{};
+        auto threads = std::vector<std::thread>();
+
+        for (auto t = size_t{0}; t < THREADS; t++) {
+            threads.emplace_back([&] {
+                for (auto i = uint32_t{0}; i < COUNT; i++) {
+                    static_cast<void>(buf.push_wait(i));
+                }
+            });
+
+            threads.emplace_back([&] {
+                for (auto i = uint32_t{0}; i < COUNT; i++) {
+                    static_cast<void>(buf.pop_wait());
+                }
+            });
+        }
+
+        for (auto& thread : threads) thread.join();
+
+        THEN("Every element should be timed once") {
+            REQUIRE(buf.latency().count() == THREADS * COUNT);
+        }
+    }
+}
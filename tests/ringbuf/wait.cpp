@@ -0,0 +1,246 @@
+/// Tests for the blocking push_wait() and pop_wait() functions.
+
+#include <chrono>
+#include <expected>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "mpmc.hpp"
+#include "ringbuf.hpp"
+#include "spsc.hpp"
+
+////////////////////////////////////////////////////////////////
+
+constexpr auto CAPACITY = size_t{8};
+
+using SpscRingBuffer = core::ringbuf::SpscRingBuffer<uint32_t, CAPACITY>;
+using MpmcRingBuffer = core::ringbuf::MpmcRingBuffer<uint32_t, CAPACITY>;
+
+using Error = core::ringbuf::Error;
+
+using namespace std::chrono_literals;
+
+////////////////////////////////////////////////////////////////
+
+template<typename Buffer>
+auto check_timeouts() -> void {
+    auto buf = Buffer{};
+
+    WHEN("pop_wait_for() is called on an empty buffer") {
+        const auto start = std::chrono::steady_clock::now();
+        const auto result = buf.pop_wait_for(10ms);
+
+        THEN("It should return Empty once the timeout expires") {
+            REQUIRE(result.error() == Error::Empty());
+            REQUIRE(std::chrono::steady_clock::now() - start >= 10ms);
+        }
+    }
+
+    WHEN("push_wait_for() is called on a full buffer") {
+        for (auto i = uint32_t{0}; i < CAPACITY; i++) {
+            REQUIRE(buf.push_wait(i));
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto result = buf.push_wait_for(99, 10ms);
+
+        THEN("It should return Full once the timeout expires") {
+            REQUIRE(result.error() == Error::Full());
+            REQUIRE(std::chrono::steady_clock::now() - start >= 10ms);
+            REQUIRE(buf.size() == CAPACITY);
+        }
+    }
+
+    WHEN("The timed functions are called when they can proceed") {
+        THEN("They should succeed without waiting") {
+            REQUIRE(buf.push_wait_for(7, 0ns));
+            REQUIRE(buf.pop_wait_for(0ns) == 7);
+        }
+    }
+}
+
+template<typename Buffer>
+auto check_wake() -> void {
+    auto buf = Buffer{};
+
+    WHEN("A consumer is blocked in pop_wait() on an empty buffer") {
+        auto popped = uint32_t{0};
+        auto consumer = std::thread([&] { popped = *buf.pop_wait(); });
+        std::this_thread::sleep_for(20ms);
+
+        THEN("A push should wake it with the pushed element") {
+            REQUIRE(buf.push_wait(42));
+            consumer.join();
+
+            REQUIRE(popped == 42);
+            REQUIRE(buf.empty());
+        }
+    }
+
+    WHEN("A producer is blocked in push_wait() on a full buffer") {
+        for (auto i = uint32_t{0}; i < CAPACITY; i++) {
+            REQUIRE(buf.push_wait(i));
+        }
+
+        auto producer = std::thread([&] { static_cast<void>(buf.push_wait(99)); });
+        std::this_thread::sleep_for(20ms);
+
+        THEN("A pop should let it complete its push") {
+            REQUIRE(buf.pop_wait() == 0);
+            producer.join();
+
+            REQUIRE(buf.full());
+        }
+    }
+}
+
+template<typename Buffer>
+auto check_transfer() -> void {
+    constexpr auto COUNT = uint32_t{100'000};
+    auto buf = Buffer{};
+
+    WHEN("One thread pushes a sequence and another pops it, using only blocking calls") {
+        auto producer = std::thread([&] {
+            for (auto i = uint32_t{0}; i < COUNT; i++) {
+                static_cast<void>(buf.push_wait(i));
+            }
+        });
+
+        auto received = std::vector<uint32_t>();
+        received.reserve(COUNT);
+
+        for (auto i = uint32_t{0}; i < COUNT; i++) {
+            received.push_back(*buf.pop_wait());
+        }
+
+        producer.join();
+
+        THEN("Every element should arrive in order") {
+            auto in_order = true;
+            for (auto i = uint32_t{0}; i < COUNT; i++) {
+                in_order = in_order && received[i] == i;
+            }
+
+            REQUIRE(in_order);
+            REQUIRE(buf.empty());
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("Blocking waits time out") {
+    GIVEN("An SpscRingBuffer") {
+        check_timeouts<SpscRingBuffer>();
+    }
+
+    GIVEN("An MpmcRingBuffer") {
+        check_timeouts<MpmcRingBuffer>();
+    }
+}
+
+SCENARIO("Blocked threads are woken") {
+    GIVEN("An SpscRingBuffer") {
+        check_wake<SpscRingBuffer>();
+    }
+
+    GIVEN("An MpmcRingBuffer") {
+        check_wake<MpmcRingBuffer>();
+    }
+}
+
+SCENARIO("Transfers between threads using blocking calls") {
+    GIVEN("An SpscRingBuffer") {
+        check_transfer<SpscRingBuffer>();
+    }
+
+    GIVEN("An MpmcRingBuffer") {
+        check_transfer<MpmcRingBuffer>();
+    }
+}
+
+template<typename Buffer>
+auto check_close() -> void {
+    auto buf = Buffer{};
+
+    WHEN("A consumer is blocked in pop_wait() when the buffer is closed") {
+        auto result = std::expected<uint32_t, Error>{};
+        auto consumer = std::thread([&] { result = buf.pop_wait(); });
+        std::this_thread::sleep_for(20ms);
+
+        buf.close();
+        consumer.join();
+
+        THEN("It should be woken with Closed") {
+            REQUIRE(result.error() == Error::Closed());
+        }
+
+        THEN("Further waits should fail with Closed straight away") {
+            REQUIRE(buf.push_wait(1).error() == Error::Closed());
+            REQUIRE(buf.pop_wait().error() == Error::Closed());
+        }
+    }
+
+    WHEN("A buffer holding data is closed") {
+        REQUIRE(buf.push_wait(1));
+        REQUIRE(buf.push_wait(2));
+        buf.close();
+
+        THEN("pop_wait() should drain the data before failing with Closed") {
+            REQUIRE(buf.pop_wait() == 1);
+            REQUIRE(buf.pop_wait() == 2);
+            REQUIRE(buf.pop_wait().error() == Error::Closed());
+        }
+    }
+}
+
+SCENARIO("Closing a buffer ends blocking waits") {
+    GIVEN("An SpscRingBuffer") {
+        check_close<SpscRingBuffer>();
+    }
+
+    GIVEN("An MpmcRingBuffer") {
+        check_close<MpmcRingBuffer>();
+    }
+}
+
+SCENARIO("MpmcRingBuffer blocking waits with several producers and consumers") {
+    GIVEN("An MpmcRingBuffer shared by several producers and consumers") {
+        constexpr auto THREADS = size_t{4};
+        constexpr auto COUNT = uint32_t{10'000};
+        auto buf = MpmcRingBuffer{};
+
+        WHEN("Each producer pushes a sequence and each consumer pops as many elements") {
+            auto producers = std::vector<std::thread>();
+            auto consumers = std::vector<std::thread>();
+            auto sums = std::vector<uint64_t>(THREADS);
+
+            for (auto t = size_t{0}; t < THREADS; t++) {
+                producers.emplace_back([&buf] {
+                    for (auto i = uint32_t{1}; i <= COUNT; i++) {
+                        static_cast<void>(buf.push_wait(i));
+                    }
+                });
+
+                consumers.emplace_back([&buf, &sum = sums[t]] {
+                    for (auto i = uint32_t{0}; i < COUNT; i++) {
+                        sum += *buf.pop_wait();
+                    }
+                });
+            }
+
+            for (auto& thread : producers) thread.join();
+            for (auto& thread : consumers) thread.join();
+
+            THEN("Every element should be received exactly once") {
+                auto total = uint64_t{0};
+                for (const auto sum : sums) total += sum;
+
+                REQUIRE(total == THREADS * (uint64_t{COUNT} * (COUNT + 1) / 2));
+                REQUIRE(buf.empty());
+            }
+        }
+    }
+}
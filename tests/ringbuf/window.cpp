@@ -0,0 +1,151 @@
+/// Tests for SlidingWindow.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+#include "window.hpp"
+
+////////////////////////////////////////////////////////////////
+
+template<typename T, size_t Capacity>
+using SlidingWindow = core::ringbuf::SlidingWindow<T, Capacity>;
+
+using Error = core::ringbuf::Error;
+
+////////////////////////////////////////////////////////////////
+
+SCENARIO("SlidingWindow aggregates the samples in the window") {
+    constexpr auto CAPACITY = size_t{16};
+
+    GIVEN("An empty window") {
+        auto window = SlidingWindow<int32_t, CAPACITY>{};
+
+        THEN("The sum should be zero and the other aggregates should fail") {
+            REQUIRE(window.sum() == 0);
+            REQUIRE(window.mean().error() == Error::Empty());
+            REQUIRE(window.min().error() == Error::Empty());
+            REQUIRE(window.max().error() == Error::Empty());
+        }
+    }
+
+    GIVEN("A window of integer samples") {
+        auto window = SlidingWindow<int32_t, CAPACITY>{};
+        auto history = std::vector<int32_t>();
+
+        auto generator = std::mt19937(GENERATE(1U, 2U, 3U));
+        auto distribution = std::uniform_int_distribution<int32_t>(-1000, 1000);
+
+        WHEN("Many more samples than the window holds are pushed") {
+            THEN("Every aggregate should match recomputing it from the last samples") {
+                for (auto i = 0; i < 1000; i++) {
+                    const auto sample = distribution(generator);
+
+                    window.push(sample);
+                    history.push_back(sample);
+
+                    const auto first = std::next(
+                        history.begin(),
+                        static_cast<std::ptrdiff_t>(history.size() - window.size()));
+                    const auto sum = std::accumulate(first, history.end(), int32_t{0});
+
+                    REQUIRE(window.size() == std::min(history.size(), CAPACITY));
+                    REQUIRE(window.sum() == sum);
+                    REQUIRE(window.mean() == sum / static_cast<int32_t>(window.size()));
+                    REQUIRE(window.min() == *std::min_element(first, history.end()));
+                    REQUIRE(window.max() == *std::max_element(first, history.end()));
+                }
+            }
+        }
+    }
+
+    GIVEN("A window of repeated samples") {
+        auto window = SlidingWindow<uint8_t, 4>{};
+
+        for (const auto sample : {3, 3, 1, 1, 3, 3}) {
+            window.push(static_cast<uint8_t>(sample));
+        }
+
+        THEN("Ties should be evicted in order") {
+            REQUIRE(window.min() == 1);
+            REQUIRE(window.max() == 3);
+
+            window.push(3);
+            window.push(3);
+
+            REQUIRE(window.min() == 3);
+        }
+    }
+
+    GIVEN("Full windows of samples at the limits of narrow integer types") {
+        const auto check = []<typename T>(const T sample) {
+            auto window = SlidingWindow<T, 300>{};
+
+            for (auto i = 0; i < 1000; i++) {
+                window.push(sample);
+            }
+
+            REQUIRE(window.sum() == static_cast<int64_t>(sample) * 300);
+            REQUIRE(window.mean() == sample);
+        };
+
+        THEN("The sum and mean shouldn't overflow") {
+            check(std::numeric_limits<uint8_t>::max());
+            check(std::numeric_limits<int8_t>::max());
+            check(std::numeric_limits<int8_t>::min());
+            check(std::numeric_limits<int16_t>::max());
+            check(std::numeric_limits<int16_t>::min());
+            check(std::numeric_limits<uint16_t>::max());
+        }
+    }
+
+    GIVEN("A window of floating point samples") {
+        auto window = SlidingWindow<double, CAPACITY>{};
+
+        WHEN("Large samples are pushed through it before small ones") {
+            for (auto i = 0; i < 1000; i++) {
+                window.push(1e16);
+                window.push(-1e16);
+            }
+
+            for (auto i = size_t{0}; i < CAPACITY; i++) {
+                window.push(0.1);
+            }
+
+            THEN("The running sum shouldn't have drifted") {
+                REQUIRE(std::abs(window.sum() - (0.1 * CAPACITY)) < 1e-9);
+                REQUIRE(std::abs(*window.mean() - 0.1) < 1e-9);
+                REQUIRE(window.min() == 0.1);
+                REQUIRE(window.max() == 0.1);
+            }
+        }
+    }
+
+    GIVEN("A full window") {
+        auto window = SlidingWindow<int32_t, CAPACITY>{};
+
+        for (auto i = int32_t{0}; i < 2 * static_cast<int32_t>(CAPACITY); i++) {
+            window.push(i);
+        }
+
+        WHEN("It's cleared and new samples pushed") {
+            window.clear();
+            window.push(-5);
+            window.push(5);
+
+            THEN("Only the new samples should be aggregated") {
+                REQUIRE(window.size() == 2);
+                REQUIRE(window.sum() == 0);
+                REQUIRE(window.min() == -5);
+                REQUIRE(window.max() == 5);
+            }
+        }
+    }
+}